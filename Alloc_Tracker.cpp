@@ -0,0 +1,295 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Alloc_Tracker.h"
+#include "Config.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#if !defined(NDEBUG) && defined(_WIN32)
+#include <windows.h>
+#define ER_ALLOC_SITES 1
+#elif !defined(NDEBUG) && __has_include(<execinfo.h>)
+#include <execinfo.h>
+#include <unistd.h>
+#define ER_ALLOC_SITES 1
+#endif
+
+namespace
+{
+    thread_local bool t_frameThread = false;
+    thread_local bool t_inHook = false;     // backtrace() can allocate; don't recurse into site capture
+
+#ifdef ER_ALLOC_TRACKER_ENABLED
+    // Every tracked block carries its size in front, so frees can be counted without a lookup
+    const size_t HEADER_SIZE = alignof(max_align_t) > sizeof(size_t) ? alignof(max_align_t) : sizeof(size_t);
+
+    void* Tracked_Allocate(size_t bytes, bool fromSDL)
+    {
+        void* block = malloc(bytes + HEADER_SIZE);
+        if (!block) return nullptr;
+        *static_cast<size_t*>(block) = bytes;
+        Alloc_Tracker::GetInstance().On_Allocate(bytes, fromSDL);
+        return static_cast<char*>(block) + HEADER_SIZE;
+    }
+
+    void Tracked_Free(void* pointer)
+    {
+        if (!pointer) return;
+        void* block = static_cast<char*>(pointer) - HEADER_SIZE;
+        Alloc_Tracker::GetInstance().On_Free(*static_cast<size_t*>(block));
+        free(block);
+    }
+
+    void* Tracked_Reallocate(void* pointer, size_t bytes)
+    {
+        if (!pointer) return Tracked_Allocate(bytes, true);
+        void* block = static_cast<char*>(pointer) - HEADER_SIZE;
+        size_t oldBytes = *static_cast<size_t*>(block);
+
+        void* grown = realloc(block, bytes + HEADER_SIZE);
+        if (!grown) return nullptr;
+        *static_cast<size_t*>(grown) = bytes;
+        Alloc_Tracker::GetInstance().On_Free(oldBytes);
+        Alloc_Tracker::GetInstance().On_Allocate(bytes, true);
+        return static_cast<char*>(grown) + HEADER_SIZE;
+    }
+
+    void* SDLCALL SDL_Malloc_Hook(size_t size) { return Tracked_Allocate(size, true); }
+    void* SDLCALL SDL_Calloc_Hook(size_t count, size_t size)
+    {
+        void* pointer = Tracked_Allocate(count * size, true);
+        if (pointer) memset(pointer, 0, count * size);
+        return pointer;
+    }
+    void* SDLCALL SDL_Realloc_Hook(void* pointer, size_t size) { return Tracked_Reallocate(pointer, size); }
+    void SDLCALL SDL_Free_Hook(void* pointer) { Tracked_Free(pointer); }
+#endif
+}
+
+#ifdef ER_ALLOC_TRACKER_ENABLED
+// Global replacements. The aligned overloads are left to the runtime and aren't counted.
+void* operator new(size_t bytes)
+{
+    void* pointer = Tracked_Allocate(bytes, false);
+    if (!pointer) throw bad_alloc();
+    return pointer;
+}
+void* operator new[](size_t bytes) { return operator new(bytes); }
+void* operator new(size_t bytes, const nothrow_t&) noexcept { return Tracked_Allocate(bytes, false); }
+void* operator new[](size_t bytes, const nothrow_t&) noexcept { return Tracked_Allocate(bytes, false); }
+void operator delete(void* pointer) noexcept { Tracked_Free(pointer); }
+void operator delete[](void* pointer) noexcept { Tracked_Free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { Tracked_Free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { Tracked_Free(pointer); }
+void operator delete(void* pointer, const nothrow_t&) noexcept { Tracked_Free(pointer); }
+void operator delete[](void* pointer, const nothrow_t&) noexcept { Tracked_Free(pointer); }
+#endif
+
+Alloc_Tracker::Alloc_Tracker()
+{
+    // Only reads the environment: this can run from inside the very first operator new
+    m_assertSteady = Config_Flag("ER_ALLOC_ASSERT");
+    m_warmupFrames = Config_Int("ER_ALLOC_WARMUP_FRAMES", 300);
+}
+
+void Alloc_Tracker::Install_SDL_Hooks()
+{
+#ifdef ER_ALLOC_TRACKER_ENABLED
+    if (SDL_SetMemoryFunctions(SDL_Malloc_Hook, SDL_Calloc_Hook, SDL_Realloc_Hook, SDL_Free_Hook) != 0)
+    {
+        cerr << "Failed to hook SDL allocations: " << SDL_GetError() << endl;
+    }
+#endif
+}
+
+void Alloc_Tracker::On_Allocate(size_t bytes, bool fromSDL)
+{
+    m_totalCount.fetch_add(1, memory_order_relaxed);
+    m_totalBytes.fetch_add(bytes, memory_order_relaxed);
+    if (fromSDL) m_sdlCount.fetch_add(1, memory_order_relaxed);
+
+    int64_t live = m_liveBytes.fetch_add(static_cast<int64_t>(bytes), memory_order_relaxed) + static_cast<int64_t>(bytes);
+    int64_t peak = m_peakLiveBytes.load(memory_order_relaxed);
+    while (live > peak && !m_peakLiveBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {}
+
+    if (!t_frameThread)
+    {
+        m_backgroundCount.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    Counters& counters = m_frame[Frame_Profiler::Current_Phase()];
+    counters.count++;
+    counters.bytes += bytes;
+
+    if (!t_inHook)
+    {
+        t_inHook = true;
+        Record_Site(bytes);
+        t_inHook = false;
+    }
+}
+
+void Alloc_Tracker::On_Free(size_t bytes)
+{
+    m_liveBytes.fetch_sub(static_cast<int64_t>(bytes), memory_order_relaxed);
+}
+
+void Alloc_Tracker::Record_Site(size_t bytes)
+{
+#ifdef ER_ALLOC_SITES
+    void* frames[SITE_DEPTH + 3];
+#ifdef _WIN32
+    int depth = CaptureStackBackTrace(0, SITE_DEPTH + 3, frames, nullptr);
+#else
+    int depth = backtrace(frames, SITE_DEPTH + 3);
+#endif
+    // Skip this function, On_Allocate and the hook itself
+    const int SKIP = 3;
+    depth = clamp(depth - SKIP, 0, static_cast<int>(SITE_DEPTH));
+    void** stack = frames + SKIP;
+
+    size_t hash = 1469598103934665603ull;
+    for (int i = 0; i < depth; ++i) hash = (hash ^ reinterpret_cast<uintptr_t>(stack[i])) * 1099511628211ull;
+
+    while (m_sitesLock.test_and_set(memory_order_acquire)) {}
+    for (int probe = 0; probe < MAX_SITES; ++probe)
+    {
+        Site& site = m_sites[(hash + probe) % MAX_SITES];
+        bool empty = site.count == 0;
+        bool same = !empty && site.depth == depth && equal(stack, stack + depth, site.frames);
+        if (empty || same)
+        {
+            if (empty)
+            {
+                copy(stack, stack + depth, site.frames);
+                site.depth = depth;
+            }
+            site.count++;
+            site.bytes += bytes;
+            m_sitesLock.clear(memory_order_release);
+            return;
+        }
+    }
+    m_sitesLock.clear(memory_order_release);
+    m_droppedSites.fetch_add(1, memory_order_relaxed);
+#else
+    (void)bytes;
+#endif
+}
+
+void Alloc_Tracker::Begin_Frame()
+{
+#ifdef ER_ALLOC_TRACKER_ENABLED
+    t_frameThread = true;
+    for (Counters& counters : m_frame) counters = Counters();
+#endif
+}
+
+void Alloc_Tracker::End_Frame(bool steadyState)
+{
+#ifndef ER_ALLOC_TRACKER_ENABLED
+    (void)steadyState;
+#else
+    copy(begin(m_frame), end(m_frame), m_lastFrame);
+    m_frameCount++;
+
+    Counters total = Last_Frame_Total();
+    if (total.count > m_worstFrame.count) m_worstFrame = total;
+
+    m_steadyFrames = steadyState ? m_steadyFrames + 1 : 0;
+    if (m_steadyFrames <= m_warmupFrames) return;
+
+    m_steadyFrameCount++;
+    for (int i = 0; i < PHASE_SLOTS; ++i)
+    {
+        m_steadyTotal[i].count += m_lastFrame[i].count;
+        m_steadyTotal[i].bytes += m_lastFrame[i].bytes;
+    }
+
+    if (m_assertSteady && total.count > 0)
+    {
+        cerr << "Allocation in steady state: frame " << m_frameCount << " made " << total.count << " allocations (" << total.bytes << " bytes)" << endl;
+        for (int i = 0; i < PHASE_SLOTS; ++i)
+        {
+            if (m_lastFrame[i].count == 0) continue;
+            cerr << "  " << (i < Frame_Profiler::PHASE_COUNT ? Frame_Profiler::Phase_Name(i) : "Other") << ": " << m_lastFrame[i].count << endl;
+        }
+        Print_Sites(10);
+        abort();
+    }
+#endif
+}
+
+Alloc_Tracker::Counters Alloc_Tracker::Last_Frame_Total() const
+{
+    Counters total;
+    for (const Counters& counters : m_lastFrame)
+    {
+        total.count += counters.count;
+        total.bytes += counters.bytes;
+    }
+    return total;
+}
+
+void Alloc_Tracker::Print_Sites(int limit)
+{
+#ifdef ER_ALLOC_SITES
+    // Copy out under the lock; sorting and printing happen without it
+    static Site sorted[MAX_SITES];
+    int used = 0;
+    while (m_sitesLock.test_and_set(memory_order_acquire)) {}
+    for (const Site& site : m_sites)
+    {
+        if (site.count) sorted[used++] = site;
+    }
+    m_sitesLock.clear(memory_order_release);
+
+    partial_sort(sorted, sorted + min(limit, used), sorted + used, [](const Site& a, const Site& b) { return a.count > b.count; });
+
+    fprintf(stderr, "Top allocation sites on the game thread:\n");
+    for (int i = 0; i < min(limit, used); ++i)
+    {
+        fprintf(stderr, "#%d: %llu allocations, %llu bytes\n", i + 1, (unsigned long long)sorted[i].count, (unsigned long long)sorted[i].bytes);
+#ifdef _WIN32
+        for (int f = 0; f < sorted[i].depth; ++f) fprintf(stderr, "    %p\n", sorted[i].frames[f]);
+#else
+        backtrace_symbols_fd(sorted[i].frames, sorted[i].depth, STDERR_FILENO);
+#endif
+    }
+    if (m_droppedSites) fprintf(stderr, "(%u allocations from untracked sites, table full)\n", m_droppedSites.load());
+#else
+    (void)limit;
+#endif
+}
+
+void Alloc_Tracker::Print_Report()
+{
+#ifdef ER_ALLOC_TRACKER_ENABLED
+    cout << "--- Allocations ---" << endl;
+    cout << "Total: " << m_totalCount << " (" << m_totalBytes / 1024 << " KB), " << m_sdlCount << " from SDL, " << m_backgroundCount << " off the game thread" << endl;
+    cout << "Peak live: " << m_peakLiveBytes / 1024 << " KB, still live at exit: " << m_liveBytes / 1024 << " KB" << endl;
+    cout << "Worst frame: " << m_worstFrame.count << " allocations (" << m_worstFrame.bytes << " bytes)" << endl;
+
+    if (m_steadyFrameCount)
+    {
+        cout << "Per steady-state frame, over " << m_steadyFrameCount << " frames:" << endl;
+        for (int i = 0; i < PHASE_SLOTS; ++i)
+        {
+            const Counters& total = m_steadyTotal[i];
+            if (total.count == 0) continue;
+            cout << "  " << (i < Frame_Profiler::PHASE_COUNT ? Frame_Profiler::Phase_Name(i) : "Other") << ": "
+                 << static_cast<double>(total.count) / m_steadyFrameCount << " allocations, "
+                 << static_cast<double>(total.bytes) / m_steadyFrameCount << " bytes" << endl;
+        }
+    }
+    Print_Sites(10);
+#endif
+}
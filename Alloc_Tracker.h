@@ -0,0 +1,91 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_ALLOC_TRACKER_H
+#define ENDLESS_RUNNER_ALLOC_TRACKER_H
+
+#include "Frame_Profiler.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// Counts heap allocations from operator new and from SDL (through SDL_SetMemoryFunctions).
+// Allocations on the game thread are charged to the current frame and to the profiler phase
+// they happened in; everything else is counted as background. Build with -DER_ALLOC_TRACKER=ON,
+// otherwise the hooks aren't compiled and every call here does nothing.
+class Alloc_Tracker
+{
+public:
+    static const int PHASE_SLOTS = Frame_Profiler::PHASE_COUNT + 1;   // Last slot is "outside any phase"
+    static const int MAX_SITES = 1024;
+    static const int SITE_DEPTH = 12;   // Debug builds spend several frames inside std::allocator
+
+    struct Counters
+    {
+        uint32_t count = 0;
+        uint64_t bytes = 0;
+    };
+
+    // Debug builds remember where allocations come from, keyed by a few return addresses
+    struct Site
+    {
+        void* frames[SITE_DEPTH];
+        int depth;
+        uint64_t count;
+        uint64_t bytes;
+    };
+private:
+    Alloc_Tracker();
+
+    bool m_assertSteady = false;   // ER_ALLOC_ASSERT: abort on any allocation once play has settled
+    int m_warmupFrames;            // ER_ALLOC_WARMUP_FRAMES
+    int m_steadyFrames = 0;
+
+    Counters m_frame[PHASE_SLOTS];            // Game thread only
+    Counters m_lastFrame[PHASE_SLOTS];
+    Counters m_steadyTotal[PHASE_SLOTS];
+    uint64_t m_steadyFrameCount = 0;
+    Counters m_worstFrame;
+    uint64_t m_frameCount = 0;
+
+    atomic<uint64_t> m_totalCount{0};
+    atomic<uint64_t> m_totalBytes{0};
+    atomic<uint64_t> m_sdlCount{0};
+    atomic<uint64_t> m_backgroundCount{0};
+    atomic<int64_t> m_liveBytes{0};
+    atomic<int64_t> m_peakLiveBytes{0};
+
+    Site m_sites[MAX_SITES] = {};
+    atomic_flag m_sitesLock = ATOMIC_FLAG_INIT;
+    atomic<uint32_t> m_droppedSites{0};
+
+    void Record_Site(size_t bytes);
+    void Print_Sites(int limit);
+public:
+    static Alloc_Tracker& GetInstance()
+    {
+        static Alloc_Tracker instance;
+        return instance;
+    }
+
+    // Must run before SDL allocates anything, so it's the first thing Game's constructor does
+    void Install_SDL_Hooks();
+
+    // Called by the hooks
+    void On_Allocate(size_t bytes, bool fromSDL);
+    void On_Free(size_t bytes);
+
+    // The calling thread becomes the frame thread. steadyState is true while nothing should be allocating.
+    void Begin_Frame();
+    void End_Frame(bool steadyState);
+
+    const Counters* Last_Frame() const { return m_lastFrame; }
+    Counters Last_Frame_Total() const;
+    void Print_Report();
+};
+
+
+#endif //ENDLESS_RUNNER_ALLOC_TRACKER_H
@@ -0,0 +1,81 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Animation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Indexed by Clip_Id
+    const Animation_Clip CLIPS[] = {
+            // row, first, count, seconds, loop, width, height, columns, rows, offsetY
+            { 2, 0, 2, 0.2f, true, 69, 94, 0, 0, 4 },       // PLAYER_RUN: 3rd row of the Kenney sheet
+            { 3, 1, 1, 0.2f, false, 69, 94, 0, 0, 4 },      // PLAYER_JUMP: a single frame
+            { 3, 0, 1, 0.2f, false, 69, 94, 0, 0, 4 },      // PLAYER_FALL: a single frame
+            { 0, 0, 10, 0.1f, true, 0, 0, 10, 1, 0 },       // COIN_SPIN
+            { 0, 0, 10, 0.1f, true, 0, 0, 10, 1, 0 },       // POWER_UP_SPIN
+            { 0, 0, 10, 0.1f, true, 0, 0, 10, 1, 0 },       // HEALTH_SPIN
+    };
+    static_assert(sizeof(CLIPS) / sizeof(CLIPS[0]) == static_cast<size_t>(Clip_Id::COUNT), "One clip per Clip_Id");
+}
+
+const Animation_Clip& Get_Clip(Clip_Id id)
+{
+    return CLIPS[static_cast<int>(id)];
+}
+
+int Animation_Clip::Frame_At(double seconds) const
+{
+    if (frameCount <= 1 || seconds <= 0.0) return firstFrame;
+
+    int frame = static_cast<int>(seconds / frameSeconds);
+    if (loop)
+    {
+        frame %= frameCount;
+    }
+    else
+    {
+        frame = min(frame, frameCount - 1);
+    }
+    return firstFrame + frame;
+}
+
+SDL_Rect Animation_Clip::Source_Rect(SDL_Texture* texture, int frame) const
+{
+    int width = frameWidth;
+    int height = frameHeight;
+    if (width == 0 || height == 0)
+    {
+        int textureWidth = 0, textureHeight = 0;
+        SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight);
+        width = textureWidth / max(columns, 1);
+        height = textureHeight / max(rows, 1);
+    }
+    return { frame * width, row * height + offsetY, width, height };
+}
+
+float Animation_Clock::Start_Phase(const Animation_Clip& clip) const
+{
+    // Looping clips only need the phase modulo their duration, which keeps it small enough for a float
+    if (clip.loop)
+    {
+        double duration = clip.Duration();
+        return static_cast<float>(duration - fmod(m_seconds, duration));
+    }
+    return static_cast<float>(-m_seconds);
+}
+
+int Animation_Clock::Frame(const Animation_Clip& clip, float phase) const
+{
+    // The phase is rounded to a float, so a clip started this frame can land just short of a
+    // whole period. The nudge keeps it on its first frame instead of wrapping to the last.
+    const double ROUNDING_NUDGE = 1e-4;
+    double seconds = m_seconds + phase + ROUNDING_NUDGE;
+    if (clip.loop)
+    {
+        return clip.Frame_At(fmod(seconds, clip.Duration()));
+    }
+    return clip.Frame_At(seconds);
+}
@@ -0,0 +1,71 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_ANIMATION_H
+#define ENDLESS_RUNNER_ANIMATION_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+using namespace std;
+
+// Every animation in the game, defined once in Animation.cpp
+enum class Clip_Id : uint8_t { PLAYER_RUN, PLAYER_JUMP, PLAYER_FALL, COIN_SPIN, POWER_UP_SPIN, HEALTH_SPIN, COUNT };
+
+struct Animation_Clip
+{
+    int row;                // Row on the sprite sheet
+    int firstFrame;         // Column of the first frame on that row
+    int frameCount;
+    float frameSeconds;     // How long each frame is shown
+    bool loop;              // Otherwise it holds on the last frame
+
+    // Frame size in pixels, or 0 to split the sheet evenly into columns x rows
+    int frameWidth;
+    int frameHeight;
+    int columns;
+    int rows;
+    int offsetY;            // Extra pixels down from the top of the row
+
+    float Duration() const { return frameSeconds * frameCount; }
+
+    // Which column to draw, given how long the clip has been playing
+    int Frame_At(double seconds) const;
+
+    // Where that frame is on the sheet. The size comes from the texture, so reloads are picked up.
+    SDL_Rect Source_Rect(SDL_Texture* texture, int frame) const;
+};
+
+const Animation_Clip& Get_Clip(Clip_Id id);
+
+// Animations don't keep their own timers: they all read this clock, advanced once per played
+// frame, plus a phase stored where they started. Nothing needs updating per entity.
+class Animation_Clock
+{
+private:
+    double m_seconds = 0.0;
+
+    Animation_Clock() = default;
+public:
+    static Animation_Clock& GetInstance()
+    {
+        static Animation_Clock instance;
+        return instance;
+    }
+
+    void Advance(float deltaTime) { m_seconds += deltaTime; }
+    double Now() const { return m_seconds; }
+
+    // Snapshots carry the clock, so rewinds replay animations exactly
+    void Set(double seconds) { m_seconds = seconds; }
+
+    // A phase that puts the clip on its first frame right now
+    float Start_Phase(const Animation_Clip& clip) const;
+
+    // Column to draw for a clip started with phase
+    int Frame(const Animation_Clip& clip, float phase) const;
+};
+
+
+#endif //ENDLESS_RUNNER_ANIMATION_H
@@ -0,0 +1,37 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_ARCHIVE_FORMAT_H
+#define ENDLESS_RUNNER_ARCHIVE_FORMAT_H
+
+#include <cstdint>
+
+// Layout of assets.pak, shared by the game and the asset_packer tool. All values little-endian.
+//
+//   Archive_Header
+//   Archive_Entry[entryCount]      sorted by name, so lookups can binary search
+//   name strings (not terminated)
+//   entry data, each blob aligned to ARCHIVE_ALIGNMENT
+
+const uint32_t ARCHIVE_MAGIC = 0x4B505245; // "ERPK"
+const uint32_t ARCHIVE_VERSION = 1;
+const uint32_t ARCHIVE_ALIGNMENT = 16;
+
+struct Archive_Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t namesSize;
+};
+
+struct Archive_Entry
+{
+    uint32_t nameOffset;    // From the start of the name strings
+    uint32_t nameLength;
+    uint64_t dataOffset;    // From the start of the file
+    uint64_t dataSize;
+};
+
+#endif //ENDLESS_RUNNER_ARCHIVE_FORMAT_H
@@ -0,0 +1,97 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Asset_Archive.h"
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+bool Asset_Archive::Open(const string& path)
+{
+    m_entries = nullptr;
+    m_entryCount = 0;
+
+    if (!m_file.Open(path)) return false;
+
+    const uint8_t* data = m_file.Data();
+    size_t size = m_file.Size();
+
+    Archive_Header header;
+    if (size < sizeof(header))
+    {
+        cerr << "Asset archive is truncated: " << path << endl;
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    if (header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION)
+    {
+        cerr << "Not a supported asset archive: " << path << endl;
+        m_file.Close();
+        return false;
+    }
+
+    size_t tocEnd = sizeof(header) + static_cast<size_t>(header.entryCount) * sizeof(Archive_Entry);
+    if (tocEnd + header.namesSize > size)
+    {
+        cerr << "Asset archive table of contents is truncated: " << path << endl;
+        m_file.Close();
+        return false;
+    }
+
+    // The header is 16 bytes, so the table of contents is suitably aligned inside the mapping
+    m_entries = reinterpret_cast<const Archive_Entry*>(data + sizeof(header));
+    m_names = reinterpret_cast<const char*>(data + tocEnd);
+    m_entryCount = header.entryCount;
+
+    for (uint32_t i = 0; i < m_entryCount; ++i)
+    {
+        const Archive_Entry& entry = m_entries[i];
+        if (entry.nameOffset + entry.nameLength > header.namesSize || entry.dataOffset + entry.dataSize > size)
+        {
+            cerr << "Asset archive entry " << i << " is out of bounds: " << path << endl;
+            m_entries = nullptr;
+            m_entryCount = 0;
+            m_file.Close();
+            return false;
+        }
+    }
+
+    cout << "Opened asset archive " << path << " (" << m_entryCount << " entries, " << size / 1024 << " KB)" << endl;
+    return true;
+}
+
+bool Asset_Archive::Find(const string& name, const uint8_t*& data, size_t& size) const
+{
+    if (!m_entries) return false;
+
+    // Binary search, the packer writes entries sorted by name
+    uint32_t low = 0, high = m_entryCount;
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        const Archive_Entry& entry = m_entries[mid];
+
+        string_view entryName(m_names + entry.nameOffset, entry.nameLength);
+        int order = entryName.compare(name);
+        if (order == 0)
+        {
+            data = m_file.Data() + entry.dataOffset;
+            size = static_cast<size_t>(entry.dataSize);
+            return true;
+        }
+        if (order < 0) low = mid + 1;
+        else high = mid;
+    }
+    return false;
+}
+
+SDL_RWops* Asset_Archive::Open_Entry(const string& name) const
+{
+    const uint8_t* data;
+    size_t size;
+    if (!Find(name, data, size)) return nullptr;
+
+    return SDL_RWFromConstMem(data, static_cast<int>(size));
+}
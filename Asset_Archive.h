@@ -0,0 +1,45 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_ASSET_ARCHIVE_H
+#define ENDLESS_RUNNER_ASSET_ARCHIVE_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include "Archive_Format.h"
+#include "Mapped_File.h"
+
+using namespace std;
+
+// The packed assets.pak, memory mapped for the lifetime of the game.
+// Entries are handed out as pointers into the mapping, nothing is copied.
+class Asset_Archive
+{
+private:
+    Asset_Archive() {}
+    ~Asset_Archive() {}
+
+    Mapped_File m_file;
+    const Archive_Entry* m_entries = nullptr;
+    const char* m_names = nullptr;
+    uint32_t m_entryCount = 0;
+public:
+    static Asset_Archive& GetInstance()
+    {
+        static Asset_Archive instance;
+        return instance;
+    }
+
+    bool Open(const string& path);
+    bool Is_Open() const { return m_entries != nullptr; }
+
+    // Look up an entry by asset name
+    bool Find(const string& name, const uint8_t*& data, size_t& size) const;
+
+    // Read-only SDL stream over an entry, or nullptr if the archive doesn't have it
+    SDL_RWops* Open_Entry(const string& name) const;
+};
+
+
+#endif //ENDLESS_RUNNER_ASSET_ARCHIVE_H
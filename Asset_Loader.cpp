@@ -0,0 +1,269 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Asset_Loader.h"
+#include "Asset_Archive.h"
+#include "Trace_Recorder.h"
+
+Asset_Loader::~Asset_Loader()
+{
+    // Stop handing out work and wait for whatever is mid-decode
+    m_nextJob = m_jobs.size();
+    for (auto& worker : m_workers)
+    {
+        if (worker.joinable()) worker.join();
+    }
+
+    {
+        lock_guard<mutex> lock(m_reloadMutex);
+        m_stopReloads = true;
+    }
+    m_reloadWake.notify_one();
+    if (m_reloadWorker.joinable()) m_reloadWorker.join();
+
+    for (auto& decoded : m_ready)
+    {
+        if (decoded.chunk) Mix_FreeChunk(decoded.chunk);
+    }
+}
+
+void Asset_Loader::Queue_Texture(const string& name, const string& path)
+{
+    m_jobs.push_back({ name, path, false });
+
+    // Lets the Asset_Manager reload it from the same place if it ever gets evicted
+    Asset_Manager::GetInstance().Register(name, path);
+}
+
+void Asset_Loader::Queue_Sound(const string& name, const string& path)
+{
+    m_jobs.push_back({ name, path, true });
+    Audio_Manager::GetInstance().SetPath(name, path);
+}
+
+void Asset_Loader::Start(int threadCount)
+{
+    m_startCounter = SDL_GetPerformanceCounter();
+
+    m_timeline.resize(m_jobs.size());
+    for (size_t i = 0; i < m_jobs.size(); ++i)
+    {
+        m_timeline[i].name = m_jobs[i].name;
+        m_timeline[i].isSound = m_jobs[i].isSound;
+    }
+
+    if (threadCount < 1) threadCount = 1;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        m_workers.emplace_back(&Asset_Loader::Worker_Main, this, i);
+    }
+}
+
+void Asset_Loader::Worker_Main(int index)
+{
+    ER_TRACE_THREAD("Asset loader");
+
+    while (true)
+    {
+        size_t jobIndex = m_nextJob.fetch_add(1);
+        if (jobIndex >= m_jobs.size()) return;
+
+        const Job& job = m_jobs[jobIndex];
+        Timeline_Entry& entry = m_timeline[jobIndex];
+        entry.thread = index;
+        entry.decodeStartMs = Elapsed_Ms();
+
+        Decoded decoded = { jobIndex, nullptr, nullptr };
+        ER_TRACE_SCOPE_DETAIL(job.isSound ? "Decode sound" : "Decode texture", job.name.c_str());
+        if (job.isSound)
+        {
+            // Read straight out of the mapped archive when the asset is packed, otherwise from disk
+            SDL_RWops* source = Asset_Archive::GetInstance().Open_Entry(job.name);
+            if (!source) source = SDL_RWFromFile(job.path.c_str(), "rb");
+
+            // Mix_LoadWAV decodes the whole file and converts it to the device's PCM format
+            decoded.chunk = source ? Mix_LoadWAV_RW(source, 1) : nullptr;
+            if (!decoded.chunk)
+            {
+                cerr << "Failed to load sound effect: " << job.path << " | Mix_Error: " << Mix_GetError() << endl;
+            }
+        }
+        else
+        {
+            // A cache hit is just a mapping, a miss decodes and writes the blob for next time
+            decoded.pixels = make_unique<Texture_Cache::Pixels>();
+            if (!Texture_Cache::GetInstance().Load(job.name, job.path, *decoded.pixels))
+            {
+                cerr << "Failed to load texture: " << job.path << endl;
+                decoded.pixels.reset();
+            }
+        }
+
+        entry.decodeEndMs = Elapsed_Ms();
+        entry.failed = !decoded.pixels && !decoded.chunk;
+
+        lock_guard<mutex> lock(m_readyMutex);
+        m_ready.push_back(std::move(decoded));
+    }
+}
+
+bool Asset_Loader::Pump(SDL_Renderer* renderer, int uploadBudget)
+{
+    int uploads = 0;
+    while (!Is_Done())
+    {
+        Decoded decoded;
+        {
+            lock_guard<mutex> lock(m_readyMutex);
+            if (m_ready.empty()) break;
+
+            // Sounds and failures are free to hand over, textures count against the budget
+            if (m_ready.front().pixels && uploads >= uploadBudget) break;
+
+            decoded = std::move(m_ready.front());
+            m_ready.pop_front();
+        }
+
+        const Job& job = m_jobs[decoded.job];
+        Timeline_Entry& entry = m_timeline[decoded.job];
+
+        if (decoded.chunk)
+        {
+            Audio_Manager::GetInstance().AddSound(job.name, decoded.chunk);
+        }
+        else if (decoded.pixels)
+        {
+            Uint64 uploadStart = SDL_GetPerformanceCounter();
+            ER_TRACE_SCOPE_DETAIL("Upload texture", job.name.c_str());
+
+            SDL_Texture* texture = Texture_Cache::Upload(renderer, *decoded.pixels);
+            decoded.pixels.reset();
+            if (texture)
+            {
+                Asset_Manager::GetInstance().AddTexture(job.name, texture);
+            }
+            else
+            {
+                cerr << "Failed to upload texture: " << job.path << " | Error: " << SDL_GetError() << endl;
+                entry.failed = true;
+            }
+
+            entry.uploadMs = (SDL_GetPerformanceCounter() - uploadStart) * 1000.0 / SDL_GetPerformanceFrequency();
+            uploads++;
+        }
+
+        m_finished++;
+    }
+
+    if (Is_Done())
+    {
+        for (auto& worker : m_workers)
+        {
+            if (worker.joinable()) worker.join();
+        }
+        m_workers.clear();
+        return true;
+    }
+    return false;
+}
+
+void Asset_Loader::Queue_Reload(const string& name, const string& path)
+{
+    {
+        lock_guard<mutex> lock(m_reloadMutex);
+        m_reloadJobs.push_back({ name, path, false });
+    }
+    if (!m_reloadWorker.joinable()) m_reloadWorker = thread(&Asset_Loader::Reload_Main, this);
+    m_reloadWake.notify_one();
+}
+
+void Asset_Loader::Reload_Main()
+{
+    ER_TRACE_THREAD("Asset reloader");
+
+    unique_lock<mutex> lock(m_reloadMutex);
+    while (true)
+    {
+        m_reloadWake.wait(lock, [this] { return m_stopReloads || !m_reloadJobs.empty(); });
+        if (m_stopReloads) return;
+
+        Job job = std::move(m_reloadJobs.front());
+        m_reloadJobs.pop_front();
+        lock.unlock();
+
+        auto pixels = make_unique<Texture_Cache::Pixels>();
+        {
+            ER_TRACE_SCOPE_DETAIL("Reload texture", job.name.c_str());
+            if (!Texture_Cache::GetInstance().Load(job.name, job.path, *pixels))
+            {
+                cerr << "Failed to reload texture: " << job.path << endl;
+                pixels.reset();
+            }
+        }
+
+        lock.lock();
+        m_reloaded.push_back({ std::move(job.name), std::move(pixels) });
+    }
+}
+
+void Asset_Loader::Pump_Reloads(SDL_Renderer* renderer, int uploadBudget)
+{
+    for (int uploads = 0; uploads < uploadBudget; ++uploads)
+    {
+        Reloaded reloaded;
+        {
+            lock_guard<mutex> lock(m_reloadMutex);
+            if (m_reloaded.empty()) return;
+            reloaded = std::move(m_reloaded.front());
+            m_reloaded.pop_front();
+        }
+
+        SDL_Texture* texture = nullptr;
+        if (reloaded.pixels)
+        {
+            ER_TRACE_SCOPE_DETAIL("Upload texture", reloaded.name.c_str());
+            texture = Texture_Cache::Upload(renderer, *reloaded.pixels);
+            if (!texture) cerr << "Failed to upload texture: " << reloaded.name << " | Error: " << SDL_GetError() << endl;
+        }
+        Asset_Manager::GetInstance().Reload_Done(reloaded.name, texture);
+    }
+}
+
+float Asset_Loader::Progress() const
+{
+    if (m_jobs.empty()) return 1.0f;
+    return static_cast<float>(m_finished) / static_cast<float>(m_jobs.size());
+}
+
+double Asset_Loader::Elapsed_Ms() const
+{
+    return (SDL_GetPerformanceCounter() - m_startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void Asset_Loader::Print_Report(double firstFrameMs, double interactiveMs) const
+{
+    vector<const Timeline_Entry*> entries;
+    for (const auto& entry : m_timeline) entries.push_back(&entry);
+    sort(entries.begin(), entries.end(), [](const Timeline_Entry* a, const Timeline_Entry* b) {
+        return a->decodeStartMs < b->decodeStartMs;
+    });
+
+    double decodeTotal = 0.0, uploadTotal = 0.0;
+
+    cout << "--- Startup timeline (ms) ---" << endl;
+    cout << "start\tdecode\tupload\tthread\tasset" << endl;
+    for (const Timeline_Entry* entry : entries)
+    {
+        double decodeMs = entry->decodeEndMs - entry->decodeStartMs;
+        decodeTotal += decodeMs;
+        uploadTotal += entry->uploadMs;
+
+        cout << (int)entry->decodeStartMs << "\t" << decodeMs << "\t" << entry->uploadMs << "\t" << entry->thread << "\t"
+             << entry->name << (entry->isSound ? " (sound)" : "") << (entry->failed ? " FAILED" : "") << endl;
+    }
+    cout << "Decode total: " << decodeTotal << " ms across " << m_timeline.size() << " assets" << endl;
+    cout << "Upload total: " << uploadTotal << " ms" << endl;
+    cout << "Time to first frame: " << firstFrameMs << " ms" << endl;
+    cout << "Time to interactive: " << interactiveMs << " ms" << endl;
+}
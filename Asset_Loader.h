@@ -0,0 +1,103 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_ASSET_LOADER_H
+#define ENDLESS_RUNNER_ASSET_LOADER_H
+
+#include "Asset_Manager.h"
+#include "Audio_Manager.h"
+#include "Texture_Cache.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Decodes images and sounds on worker threads. The main thread only uploads the
+// decoded pixels into textures, a few per frame, so a loading screen stays responsive.
+// After startup, one more worker decodes textures the Asset_Manager needs back (evicted
+// or registered ones) so a draw call never waits on a decode.
+class Asset_Loader
+{
+public:
+    struct Timeline_Entry
+    {
+        string name;
+        bool isSound = false;
+        int thread = -1;
+        double decodeStartMs = 0.0;
+        double decodeEndMs = 0.0;
+        double uploadMs = 0.0;     // Time spent on the main thread creating the texture
+        bool failed = false;
+    };
+private:
+    struct Job
+    {
+        string name;
+        string path;
+        bool isSound;
+    };
+
+    struct Decoded
+    {
+        size_t job;
+        unique_ptr<Texture_Cache::Pixels> pixels;
+        Mix_Chunk* chunk;
+    };
+
+    struct Reloaded
+    {
+        string name;
+        unique_ptr<Texture_Cache::Pixels> pixels;  // nullptr if the decode failed
+    };
+
+    vector<Job> m_jobs;
+    vector<Timeline_Entry> m_timeline;  // One entry per job, each written by one thread at a time
+
+    vector<thread> m_workers;
+    atomic<size_t> m_nextJob{0};
+
+    mutex m_readyMutex;
+    deque<Decoded> m_ready;
+
+    size_t m_finished = 0;              // Jobs fully handed over to the managers
+    Uint64 m_startCounter = 0;
+
+    // Reloads, started on the first request
+    thread m_reloadWorker;
+    mutex m_reloadMutex;
+    condition_variable m_reloadWake;
+    deque<Job> m_reloadJobs;
+    deque<Reloaded> m_reloaded;
+    bool m_stopReloads = false;
+
+    void Worker_Main(int index);
+    void Reload_Main();
+    double Elapsed_Ms() const;
+public:
+    Asset_Loader() {}
+    ~Asset_Loader();
+
+    void Queue_Texture(const string& name, const string& path);
+    void Queue_Sound(const string& name, const string& path);
+
+    // Spin up the workers; nothing may be queued after this
+    void Start(int threadCount);
+
+    // Upload at most uploadBudget decoded textures. Returns true once every job is done.
+    bool Pump(SDL_Renderer* renderer, int uploadBudget);
+
+    // Main thread, any time. Decodes in the background; Pump_Reloads hands it to the Asset_Manager.
+    void Queue_Reload(const string& name, const string& path);
+
+    // Once per frame. Uploads at most uploadBudget reloaded textures.
+    void Pump_Reloads(SDL_Renderer* renderer, int uploadBudget);
+
+    float Progress() const;
+    bool Is_Done() const { return m_finished == m_jobs.size(); }
+
+    void Print_Report(double firstFrameMs, double interactiveMs) const;
+};
+
+
+#endif //ENDLESS_RUNNER_ASSET_LOADER_H
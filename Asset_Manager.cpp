@@ -3,34 +3,194 @@
 //
 
 #include "Asset_Manager.h"
+#include "Asset_Loader.h"
+#include "Texture_Cache.h"
+#include "Trace_Recorder.h"
 
 void Asset_Manager::LoadTexture(const std::string& name, const std::string& path, SDL_Renderer* renderer)
 {
-    SDL_Texture* texture = IMG_LoadTexture(renderer, path.c_str());
+    ER_TRACE_SCOPE_DETAIL("Load texture", name.c_str());
+
+    // The cache hands back pre-decoded pixels when it can, and decodes (archive first, then disk) when it can't
+    Texture_Cache::Pixels pixels;
+    SDL_Texture* texture = nullptr;
+    if (Texture_Cache::GetInstance().Load(name, path, pixels))
+    {
+        texture = Texture_Cache::Upload(renderer, pixels);
+    }
+
     if (texture == nullptr)
     {
         std::cerr << "Failed to load texture: " << path << " | Error: " << IMG_GetError() << std::endl;
     }
     else
     {
-        m_textures[name] = texture;
+        AddTexture(name, texture);
+        m_slots[GetHandle(name).index].path = path;
     }
 }
 
+Texture_Handle Asset_Manager::Register(const std::string& name, const std::string& path)
+{
+    Texture_Handle handle = GetHandle(name);
+    Texture_Slot& slot = m_slots[handle.index];
+    slot.path = path;
+    slot.failed = false;
+    return handle;
+}
+
+void Asset_Manager::AddTexture(const std::string& name, SDL_Texture* texture)
+{
+    Texture_Handle handle = GetHandle(name);
+    Texture_Slot& slot = m_slots[handle.index];
+    if (slot.texture == texture) return;
+    Release_Slot(slot);
+
+    int width = 0, height = 0;
+    SDL_QueryTexture(texture, NULL, NULL, &width, &height);
+
+    slot.texture = texture;
+    slot.bytes = static_cast<size_t>(width) * height * 4;
+    slot.lastUsedFrame = m_frame;
+    m_residentBytes += slot.bytes;
+    m_loads++;
+}
+
+Texture_Handle Asset_Manager::GetHandle(const std::string& name)
+{
+    auto it = m_handles.find(name);
+    if (it != m_handles.end())
+    {
+        return it->second;
+    }
+
+    Texture_Handle handle = { static_cast<int>(m_slots.size()) };
+    m_slots.emplace_back();
+    m_names.push_back(name);
+    m_handles[name] = handle;
+    return handle;
+}
+
 SDL_Texture* Asset_Manager::GetTexture(const std::string& name)
 {
-    if (m_textures.find(name) != m_textures.end())
+    auto it = m_handles.find(name);
+    if (it != m_handles.end())
     {
-        return m_textures[name];
+        return GetTexture(it->second);
     }
     return nullptr;
 }
 
+vector<pair<string, string>> Asset_Manager::GetSources() const
+{
+    vector<pair<string, string>> sources;
+    for (size_t i = 0; i < m_slots.size(); ++i)
+    {
+        if (!m_slots[i].path.empty()) sources.push_back({ m_names[i], m_slots[i].path });
+    }
+    return sources;
+}
+
+void Asset_Manager::Load_Slot(int index)
+{
+    Texture_Slot& slot = m_slots[index];
+    if (m_loader)
+    {
+        slot.pending = true;
+        m_loader->Queue_Reload(m_names[index], slot.path);
+        return;
+    }
+    if (!m_renderer) return;
+
+    LoadTexture(m_names[index], slot.path, m_renderer);
+    if (!slot.texture) slot.failed = true;
+}
+
+void Asset_Manager::Reload_Done(const string& name, SDL_Texture* texture)
+{
+    Texture_Slot& slot = m_slots[GetHandle(name).index];
+    slot.pending = false;
+    if (texture)
+    {
+        AddTexture(name, texture);
+    }
+    else
+    {
+        slot.failed = true;
+    }
+}
+
+void Asset_Manager::Release_Slot(Texture_Slot& slot)
+{
+    if (slot.texture)
+    {
+        SDL_DestroyTexture(slot.texture);
+        m_residentBytes -= slot.bytes;
+    }
+    slot.texture = nullptr;
+    slot.bytes = 0;
+}
+
+void Asset_Manager::BeginFrame()
+{
+    m_frame++;
+    if (m_budgetBytes > 0 && m_residentBytes > m_budgetBytes)
+    {
+        Enforce_Budget();
+    }
+}
+
+void Asset_Manager::Enforce_Budget()
+{
+    // Only textures that can be reloaded and haven't been drawn for a while are up for eviction
+    vector<int> candidates;
+    for (int i = 0; i < static_cast<int>(m_slots.size()); ++i)
+    {
+        const Texture_Slot& slot = m_slots[i];
+        if (slot.texture && !slot.path.empty() && slot.lastUsedFrame + EVICTION_MARGIN_FRAMES < m_frame)
+        {
+            candidates.push_back(i);
+        }
+    }
+    sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+        return m_slots[a].lastUsedFrame < m_slots[b].lastUsedFrame;
+    });
+
+    for (int index : candidates)
+    {
+        if (m_residentBytes <= m_budgetBytes) break;
+        Release_Slot(m_slots[index]);
+        m_evictions++;
+    }
+}
+
+void Asset_Manager::Print_Residency() const
+{
+    int resident = 0;
+    for (const auto& slot : m_slots)
+    {
+        if (slot.texture) resident++;
+    }
+
+    cout << "--- Texture residency ---" << endl;
+    cout << "Resident: " << resident << "/" << m_slots.size() << " textures, " << m_residentBytes / 1024 << " KB";
+    if (m_budgetBytes > 0) cout << " of " << m_budgetBytes / 1024 << " KB budget";
+    cout << endl;
+    cout << "Loads: " << m_loads << ", evictions: " << m_evictions << endl;
+
+    for (size_t i = 0; i < m_slots.size(); ++i)
+    {
+        const Texture_Slot& slot = m_slots[i];
+        if (!slot.texture) continue;
+        cout << "  " << m_names[i] << "\t" << slot.bytes / 1024 << " KB\tlast used " << (m_frame - slot.lastUsedFrame) << " frames ago" << endl;
+    }
+}
+
 void Asset_Manager::CleanUp()
 {
-    for (auto const& [name, texture] : m_textures)
+    // Handles stay valid, their slots just go empty
+    for (Texture_Slot& slot : m_slots)
     {
-        SDL_DestroyTexture(texture);
+        Release_Slot(slot);
     }
-    m_textures.clear();
-}
\ No newline at end of file
+}
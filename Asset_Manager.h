@@ -25,12 +25,51 @@
 
 using namespace std;
 
+class Asset_Loader;
+
+// Dense index into the Asset_Manager's texture slots. Resolve names once, keep the handle.
+struct Texture_Handle
+{
+    int index = -1;
+    bool IsValid() const { return index >= 0; }
+};
+
 class Asset_Manager
 {
 private:
     Asset_Manager() {}
     ~Asset_Manager() {}
-    map<string, SDL_Texture*> m_textures;
+
+    struct Texture_Slot
+    {
+        SDL_Texture* texture = nullptr;
+        string path;                // Where to (re)load it from; empty for textures made at runtime
+        size_t bytes = 0;           // Estimated GPU size, width * height * 4
+        Uint32 lastUsedFrame = 0;
+        bool failed = false;        // A lazy load that failed is not retried every frame
+        bool pending = false;       // Reload queued on the Asset_Loader, drawn as missing until it lands
+    };
+
+    // Unused for this long before a texture may be evicted (10 s at 60 fps), so anything on
+    // screen or about to come back isn't thrashed out and in when the budget is tight
+    static const Uint32 EVICTION_MARGIN_FRAMES = 600;
+
+    map<string, Texture_Handle> m_handles;  // Only touched when resolving names
+    vector<Texture_Slot> m_slots;           // Indexed by Texture_Handle
+    vector<string> m_names;
+
+    // Residency
+    SDL_Renderer* m_renderer = nullptr;
+    Asset_Loader* m_loader = nullptr;       // Decodes reloads off the main thread when set
+    size_t m_budgetBytes = 0;               // 0 = unlimited
+    size_t m_residentBytes = 0;
+    Uint32 m_frame = 1;
+    int m_loads = 0;
+    int m_evictions = 0;
+
+    void Load_Slot(int index);
+    void Release_Slot(Texture_Slot& slot);
+    void Enforce_Budget();
 public:
     static Asset_Manager& GetInstance()
     {
@@ -38,11 +77,53 @@ public:
         return instance;
     }
 
+    // Lazy loads need a renderer to create textures with
+    void SetRenderer(SDL_Renderer* renderer) { m_renderer = renderer; }
+    void SetBudget(size_t bytes) { m_budgetBytes = bytes; }
+
+    // Evicted and registered textures are reloaded through this loader instead of inside the draw call
+    void SetLoader(Asset_Loader* loader) { m_loader = loader; }
+
+    // From the loader once a reload is uploaded; nullptr if it failed
+    void Reload_Done(const string& name, SDL_Texture* texture);
+
     // Load a texture from a file and store it by name
     void LoadTexture(const string& name, const std::string& path, SDL_Renderer* renderer);
 
-    // Get a previously loaded texture by name
+    // Remember where a texture lives without loading it; it is loaded on first use
+    Texture_Handle Register(const string& name, const string& path);
+
+    // Take ownership of a texture created elsewhere (e.g. by the Asset_Loader)
+    void AddTexture(const string& name, SDL_Texture* texture);
+
+    // Intern a name. The handle is valid right away, even before the texture is loaded.
+    Texture_Handle GetHandle(const string& name);
+
+    // O(1) lookup for hot paths. Marks the texture as used and, if it isn't resident, queues it to
+    // load and returns nullptr until it is (or loads it right away when there's no loader).
+    SDL_Texture* GetTexture(Texture_Handle handle)
+    {
+        if (handle.index < 0 || handle.index >= static_cast<int>(m_slots.size())) return nullptr;
+
+        Texture_Slot& slot = m_slots[handle.index];
+        slot.lastUsedFrame = m_frame;
+        if (!slot.texture && !slot.failed && !slot.pending && !slot.path.empty()) Load_Slot(handle.index);
+        return slot.texture;
+    }
+
+    // Get a previously loaded texture by name (tooling, not for per-frame code)
     SDL_Texture* GetTexture(const string& name);
+    const string& GetName(Texture_Handle handle) const { return m_names[handle.index]; }
+
+    // Call once per frame, before rendering. Evicts least recently used textures while over budget,
+    // but only ones unused for EVICTION_MARGIN_FRAMES; the budget is exceeded rather than thrash.
+    void BeginFrame();
+
+    // Name and source path of every texture that was loaded or registered from a file
+    vector<pair<string, string>> GetSources() const;
+
+    size_t GetResidentBytes() const { return m_residentBytes; }
+    void Print_Residency() const;
 
     // Free all loaded textures
     void CleanUp();
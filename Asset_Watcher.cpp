@@ -0,0 +1,172 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Asset_Watcher.h"
+#include <set>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+Asset_Watcher::~Asset_Watcher()
+{
+    Stop();
+}
+
+bool Asset_Watcher::Start()
+{
+#ifdef __linux__
+    for (const auto& source : Asset_Manager::GetInstance().GetSources())
+    {
+        m_assets.push_back({ source.first, source.second, false });
+    }
+    for (const auto& source : Audio_Manager::GetInstance().GetSources())
+    {
+        m_assets.push_back({ source.first, source.second, true });
+    }
+
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+    {
+        cerr << "Hot reload: inotify_init1 failed" << endl;
+        return false;
+    }
+
+    // Watch directories rather than files: most editors save by writing a new file and renaming it over the old one
+    for (size_t i = 0; i < m_assets.size(); ++i)
+    {
+        const string& path = m_assets[i].path;
+        size_t slash = path.find_last_of("/\\");
+        string directory = (slash == string::npos) ? "." : path.substr(0, slash);
+        string file = (slash == string::npos) ? path : path.substr(slash + 1);
+
+        int wd = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0)
+        {
+            cerr << "Hot reload: can't watch " << directory << endl;
+            continue;
+        }
+        m_byFile[{ wd, file }].push_back(i);
+    }
+
+    m_running = true;
+    m_thread = thread(&Asset_Watcher::Thread_Main, this);
+    cout << "Hot reload: watching " << m_byFile.size() << " files" << endl;
+    return true;
+#else
+    cerr << "Hot reload is only available on Linux" << endl;
+    return false;
+#endif
+}
+
+void Asset_Watcher::Stop()
+{
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+
+#ifdef __linux__
+    if (m_fd >= 0) close(m_fd);
+#endif
+    m_fd = -1;
+
+    for (auto& reloaded : m_ready)
+    {
+        if (reloaded.chunk) Mix_FreeChunk(reloaded.chunk);
+    }
+    m_ready.clear();
+}
+
+void Asset_Watcher::Thread_Main()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+
+    while (m_running)
+    {
+        // Wake up regularly so Stop() never waits long
+        pollfd descriptor = { m_fd, POLLIN, 0 };
+        if (poll(&descriptor, 1, 250) <= 0) continue;
+
+        // One save can raise several events; decode each touched asset once per batch
+        set<size_t> changed;
+        ssize_t length;
+        while ((length = read(m_fd, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* ptr = buffer; ptr < buffer + length; )
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                if (event->len > 0)
+                {
+                    auto it = m_byFile.find({ event->wd, string(event->name) });
+                    if (it != m_byFile.end()) changed.insert(it->second.begin(), it->second.end());
+                }
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        for (size_t index : changed)
+        {
+            Decode(m_assets[index]);
+        }
+    }
+#endif
+}
+
+void Asset_Watcher::Decode(const Watched& asset)
+{
+    Reloaded reloaded = { &asset, nullptr, nullptr };
+    if (asset.isSound)
+    {
+        reloaded.chunk = Mix_LoadWAV(asset.path.c_str());
+        if (!reloaded.chunk)
+        {
+            cerr << "Hot reload: failed to decode " << asset.path << " | Mix_Error: " << Mix_GetError() << endl;
+            return;
+        }
+    }
+    else
+    {
+        // Also rewrites the cached blob, so the next launch starts from the new art
+        reloaded.pixels = make_unique<Texture_Cache::Pixels>();
+        if (!Texture_Cache::GetInstance().Refresh(asset.path, *reloaded.pixels))
+        {
+            cerr << "Hot reload: failed to decode " << asset.path << endl;
+            return;
+        }
+    }
+
+    lock_guard<mutex> lock(m_readyMutex);
+    m_ready.push_back(std::move(reloaded));
+}
+
+void Asset_Watcher::Apply(SDL_Renderer* renderer)
+{
+    deque<Reloaded> ready;
+    {
+        lock_guard<mutex> lock(m_readyMutex);
+        if (m_ready.empty()) return;
+        ready.swap(m_ready);
+    }
+
+    for (const Reloaded& reloaded : ready)
+    {
+        if (reloaded.chunk)
+        {
+            Audio_Manager::GetInstance().AddSound(reloaded.asset->name, reloaded.chunk);
+        }
+        else
+        {
+            SDL_Texture* texture = Texture_Cache::Upload(renderer, *reloaded.pixels);
+            if (!texture)
+            {
+                cerr << "Hot reload: failed to upload " << reloaded.asset->path << " | Error: " << SDL_GetError() << endl;
+                continue;
+            }
+            Asset_Manager::GetInstance().AddTexture(reloaded.asset->name, texture);
+        }
+        cout << "Reloaded " << reloaded.asset->name << endl;
+    }
+}
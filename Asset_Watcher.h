@@ -0,0 +1,61 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_ASSET_WATCHER_H
+#define ENDLESS_RUNNER_ASSET_WATCHER_H
+
+#include "Asset_Manager.h"
+#include "Audio_Manager.h"
+#include "Texture_Cache.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// Watches the source files of loaded textures and sounds (inotify, Linux only).
+// Changed files are decoded on the watcher thread; Apply() swaps them into the
+// managers on the main thread between frames. Everything holds handles, so the
+// new texture or chunk is picked up without touching any entity.
+class Asset_Watcher
+{
+private:
+    struct Watched
+    {
+        string name;
+        string path;
+        bool isSound;
+    };
+
+    struct Reloaded
+    {
+        const Watched* asset;
+        unique_ptr<Texture_Cache::Pixels> pixels;
+        Mix_Chunk* chunk;
+    };
+
+    vector<Watched> m_assets;
+    map<pair<int, string>, vector<size_t>> m_byFile;   // (watch descriptor, file name) -> assets
+
+    int m_fd = -1;
+    thread m_thread;
+    atomic<bool> m_running{false};
+
+    mutex m_readyMutex;
+    deque<Reloaded> m_ready;
+
+    void Thread_Main();
+    void Decode(const Watched& asset);
+public:
+    Asset_Watcher() {}
+    ~Asset_Watcher();
+
+    // Watch everything the managers currently know a source file for
+    bool Start();
+    void Stop();
+
+    // Swap reloaded assets in. Call at a frame boundary.
+    void Apply(SDL_Renderer* renderer);
+};
+
+
+#endif //ENDLESS_RUNNER_ASSET_WATCHER_H
@@ -0,0 +1,125 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Async_Writer.h"
+#include "Trace_Recorder.h"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+void Async_Writer::Write(const string& path, vector<uint8_t> data)
+{
+    Queue({ path, std::move(data), false });
+}
+
+void Async_Writer::Append(const string& path, vector<uint8_t> data)
+{
+    Queue({ path, std::move(data), true });
+}
+
+void Async_Writer::Queue(Job job)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        // Started on first use, so a global Game doesn't spawn threads before main
+        if (!m_thread.joinable())
+        {
+            m_stopping = false;
+            m_thread = thread(&Async_Writer::Thread_Main, this);
+        }
+
+        bool replaced = false;
+        if (!job.append)
+        {
+            for (Job& pending : m_jobs)
+            {
+                if (!pending.append && pending.path == job.path)
+                {
+                    pending.data = std::move(job.data);
+                    replaced = true;
+                    break;
+                }
+            }
+        }
+        if (!replaced) m_jobs.push_back(std::move(job));
+    }
+    m_wake.notify_one();
+}
+
+void Async_Writer::Stop()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void Async_Writer::Thread_Main()
+{
+    ER_TRACE_THREAD("Async writer");
+
+    while (true)
+    {
+        Job job;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_jobs.empty()) return;   // Stopping, and everything is written
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        ER_TRACE_SCOPE_DETAIL(job.append ? "Append file" : "Write file", job.path.c_str());
+        bool written = job.append ? Append_File(job.path, job.data) : Write_File_Atomic(job.path, job.data);
+        if (!written)
+        {
+            cerr << "Failed to write " << job.path << endl;
+        }
+    }
+}
+
+bool Async_Writer::Write_File_Atomic(const string& path, const vector<uint8_t>& data)
+{
+    string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) return false;
+
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size() && fflush(file) == 0;
+
+    // Make sure the bytes are on disk before the rename makes them the real file
+#ifdef _WIN32
+    written = written && _commit(_fileno(file)) == 0;
+#else
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    fclose(file);
+
+    std::error_code error;
+    if (written) filesystem::rename(tempPath, path, error);
+    if (!written || error)
+    {
+        filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool Async_Writer::Append_File(const string& path, const vector<uint8_t>& data)
+{
+    FILE* file = fopen(path.c_str(), "ab");
+    if (!file) return false;
+
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && written;
+}
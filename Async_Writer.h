@@ -0,0 +1,57 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_ASYNC_WRITER_H
+#define ENDLESS_RUNNER_ASYNC_WRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Writes files on a background thread so the game thread never waits on the disk.
+// Whole-file writes go to a temp file, are flushed and renamed over the old one, so a
+// crash mid-write leaves the previous version intact.
+class Async_Writer
+{
+private:
+    struct Job
+    {
+        string path;
+        vector<uint8_t> data;
+        bool append;
+    };
+
+    thread m_thread;
+    mutex m_mutex;
+    condition_variable m_wake;
+    deque<Job> m_jobs;
+    bool m_stopping = false;
+
+    void Thread_Main();
+    void Queue(Job job);
+public:
+    Async_Writer() {}
+    ~Async_Writer() { Stop(); }
+
+    // Queue a whole-file write. A write still pending for the same path is replaced, only the latest matters.
+    void Write(const string& path, vector<uint8_t> data);
+
+    // Queue bytes to add to the end of a file. Appends keep their order and are never merged away.
+    void Append(const string& path, vector<uint8_t> data);
+
+    // Finish everything queued, then stop the thread
+    void Stop();
+
+    static bool Write_File_Atomic(const string& path, const vector<uint8_t>& data);
+    static bool Append_File(const string& path, const vector<uint8_t>& data);
+};
+
+
+#endif //ENDLESS_RUNNER_ASYNC_WRITER_H
@@ -3,21 +3,130 @@
 //
 
 #include "Audio_Manager.h"
+#include "Asset_Archive.h"
+#include "Music_Player.h"
+#include "Config.h"
+
+namespace
+{
+    // Tried smallest first in low latency mode. 256 samples is under 6 ms at 44.1 kHz.
+    const int BUFFER_SIZES[] = { 256, 512, 1024, 2048 };
+    const int BUFFER_SIZE_COUNT = sizeof(BUFFER_SIZES) / sizeof(BUFFER_SIZES[0]);
+
+    // Underruns within this many frames that make low latency mode step up a size
+    const int UNDERRUN_LIMIT = 3;
+    const Uint32 UNDERRUN_WINDOW_FRAMES = 300;
+}
 
 void Audio_Manager::Init()
 {
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
+    m_lowLatency = Config_Flag("ER_LOW_LATENCY");
+    if (!m_lowLatency)
+    {
+        Open_Device(2048);
+        return;
+    }
+
+    for (m_bufferIndex = 0; m_bufferIndex < BUFFER_SIZE_COUNT; ++m_bufferIndex)
+    {
+        if (Open_Device(BUFFER_SIZES[m_bufferIndex])) return;
+    }
+}
+
+bool Audio_Manager::Open_Device(int bufferSamples)
+{
+    // No allowed changes: SDL converts to whatever the hardware wants, and the mixer's format stays
+    // the same across reopens, so chunks converted at load time still match after a fall back
+    if (Mix_OpenAudioDevice(44100, MIX_DEFAULT_FORMAT, 2, bufferSamples, NULL, 0) < 0)
     {
         cerr << "SDL_mixer could not initialize! Mix_Error: " << Mix_GetError() << endl;
+        return false;
+    }
+
+    int channels;
+    Uint16 format;
+    Mix_QuerySpec(&m_rate, &format, &channels);
+    m_bufferSamples = bufferSamples;
+
+    Mix_AllocateChannels(VOICE_COUNT);
+    for (Voice& voice : m_voices) voice.sound = -1;
+
+    m_lastMixCounter = 0;
+    Mix_SetPostMix(&Audio_Manager::Post_Mix, this);
+
+    cout << "Audio: " << m_bufferSamples << " sample buffer (" << m_bufferSamples * 1000.0 / m_rate << " ms)" << endl;
+    return true;
+}
+
+void Audio_Manager::Fall_Back()
+{
+    if (m_bufferIndex + 1 >= BUFFER_SIZE_COUNT) return;
+
+    // Loaded chunks are already in the mixer's format, which Open_Device pins, so they survive the reopen
+    Mix_CloseAudio();
+    while (++m_bufferIndex < BUFFER_SIZE_COUNT)
+    {
+        if (Open_Device(BUFFER_SIZES[m_bufferIndex])) break;
+    }
+    Music_Player::GetInstance().Rehook();
+    Print_Latency_Stats();
+}
+
+void Audio_Manager::BeginFrame()
+{
+    m_frame++;
+
+    if (!m_lowLatency) return;
+
+    // Several underruns in a short window means this buffer is too small for the machine.
+    // At the largest size there's nothing left to fall back to, so the window just rolls on.
+    if (m_underruns - m_underrunsAtCheck >= UNDERRUN_LIMIT && m_bufferIndex + 1 < BUFFER_SIZE_COUNT)
+    {
+        cout << "Audio: underruns at " << m_bufferSamples << " samples, falling back" << endl;
+        m_underrunsAtCheck = m_underruns;
+        m_checkFrame = m_frame;
+        Fall_Back();
+    }
+    else if (m_frame - m_checkFrame >= UNDERRUN_WINDOW_FRAMES)
+    {
+        m_underrunsAtCheck = m_underruns;
+        m_checkFrame = m_frame;
+    }
+}
+
+void Audio_Manager::Post_Mix(void* userdata, Uint8* stream, int length)
+{
+    Audio_Manager* audio = static_cast<Audio_Manager*>(userdata);
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    double bufferSeconds = static_cast<double>(audio->m_bufferSamples) / audio->m_rate;
+
+    // The device asks for a buffer each time one finishes playing; a gap of two buffers means it ran dry
+    Uint64 last = audio->m_lastMixCounter.exchange(now);
+    if (last != 0 && static_cast<double>(now - last) / frequency > bufferSeconds * 2.0)
+    {
+        audio->m_underruns++;
+    }
+
+    // A sound requested before this callback is in this buffer, which starts playing about one buffer from now
+    Uint64 requested = audio->m_pendingPlay.exchange(0);
+    if (requested != 0 && requested <= now)
+    {
+        Uint32 latencyUs = static_cast<Uint32>((static_cast<double>(now - requested) / frequency + bufferSeconds) * 1000000.0);
+        audio->m_latencySamples++;
+        audio->m_latencyTotalUs += latencyUs;
+        if (latencyUs > audio->m_latencyMaxUs) audio->m_latencyMaxUs = latencyUs;
     }
 }
 
 void Audio_Manager::LoadSound(const string& name, const string& path)
 {
-    Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+    SDL_RWops* packed = Asset_Archive::GetInstance().Open_Entry(name);
+    Mix_Chunk* chunk = packed ? Mix_LoadWAV_RW(packed, 1) : Mix_LoadWAV(path.c_str());
     if (chunk != nullptr)
     {
-        m_sounds[name] = chunk;
+        AddSound(name, chunk);
+        SetPath(name, path);
     }
     else
     {
@@ -25,20 +134,170 @@ void Audio_Manager::LoadSound(const string& name, const string& path)
     }
 }
 
+void Audio_Manager::AddSound(const string& name, Mix_Chunk* chunk)
+{
+    Sound_Handle handle = GetHandle(name);
+    Mix_Chunk*& slot = m_sounds[handle.index];
+    if (slot != nullptr && slot != chunk)
+    {
+        // The mixer may still be reading the old chunk; stop those channels before freeing it
+        int channels = Mix_AllocateChannels(-1);
+        for (int i = 0; i < channels; ++i)
+        {
+            if (Mix_Playing(i) && Mix_GetChunk(i) == slot) Mix_HaltChannel(i);
+        }
+        Mix_FreeChunk(slot);
+    }
+    slot = chunk;
+}
+
+void Audio_Manager::SetPath(const string& name, const string& path)
+{
+    m_paths[GetHandle(name).index] = path;
+}
+
+vector<pair<string, string>> Audio_Manager::GetSources() const
+{
+    vector<pair<string, string>> sources;
+    for (size_t i = 0; i < m_sounds.size(); ++i)
+    {
+        if (!m_paths[i].empty()) sources.push_back({ m_names[i], m_paths[i] });
+    }
+    return sources;
+}
+
+Sound_Handle Audio_Manager::GetHandle(const string& name)
+{
+    auto it = m_handles.find(name);
+    if (it != m_handles.end())
+    {
+        return it->second;
+    }
+
+    Sound_Handle handle = { static_cast<int>(m_sounds.size()) };
+    m_sounds.push_back(nullptr);
+    m_names.push_back(name);
+    m_paths.emplace_back();
+    m_rules.emplace_back();
+    m_lastPlayedFrame.push_back(0);
+    m_handles[name] = handle;
+    return handle;
+}
+
+void Audio_Manager::SetVoiceRule(Sound_Handle handle, int priority, int maxInstances)
+{
+    if (handle.index < 0 || handle.index >= static_cast<int>(m_rules.size())) return;
+    m_rules[handle.index] = { priority, maxInstances > 0 ? maxInstances : 1 };
+}
+
+void Audio_Manager::PlaySound(Sound_Handle handle)
+{
+    if (handle.index < 0 || handle.index >= static_cast<int>(m_sounds.size())) return;
+
+    Mix_Chunk* chunk = m_sounds[handle.index];
+    if (chunk == nullptr) return;
+
+    // Plays of the same sound within one frame would only stack into a louder copy of the same voice
+    if (m_lastPlayedFrame[handle.index] == m_frame)
+    {
+        m_coalesced++;
+        return;
+    }
+
+    const Voice_Rule& rule = m_rules[handle.index];
+    int channel = Pick_Channel(handle.index, rule.priority);
+    if (channel < 0)
+    {
+        m_dropped++;
+        return;
+    }
+
+    if (Mix_PlayChannel(channel, chunk, 0) < 0) return;
+
+    m_voices[channel] = { handle.index, rule.priority, m_frame };
+
+    Uint64 expected = 0;
+    m_pendingPlay.compare_exchange_strong(expected, SDL_GetPerformanceCounter());
+    m_lastPlayedFrame[handle.index] = m_frame;
+    m_played++;
+}
+
+int Audio_Manager::Pick_Channel(int sound, int priority)
+{
+    int instances = 0;
+    int oldestInstance = -1;
+    int freeChannel = -1;
+    int victim = -1;
+
+    for (int i = 0; i < VOICE_COUNT; ++i)
+    {
+        Voice& voice = m_voices[i];
+        if (voice.sound >= 0 && !Mix_Playing(i)) voice.sound = -1;
+
+        if (voice.sound < 0)
+        {
+            if (freeChannel < 0) freeChannel = i;
+            continue;
+        }
+
+        if (voice.sound == sound)
+        {
+            instances++;
+            if (oldestInstance < 0 || voice.startFrame < m_voices[oldestInstance].startFrame) oldestInstance = i;
+        }
+
+        // Lowest priority first, oldest among equals
+        if (voice.priority <= priority && (victim < 0 || voice.priority < m_voices[victim].priority
+            || (voice.priority == m_voices[victim].priority && voice.startFrame < m_voices[victim].startFrame)))
+        {
+            victim = i;
+        }
+    }
+
+    // At the cap, the newest play restarts this sound's oldest voice
+    if (instances >= m_rules[sound].maxInstances) victim = oldestInstance;
+    else if (freeChannel >= 0) return freeChannel;
+
+    if (victim < 0) return -1;
+
+    Mix_HaltChannel(victim);
+    m_voices[victim].sound = -1;
+    m_stolen++;
+    return victim;
+}
+
 void Audio_Manager::PlaySound(const std::string& name)
 {
-    if (m_sounds.find(name) != m_sounds.end())
+    auto it = m_handles.find(name);
+    if (it != m_handles.end())
+    {
+        PlaySound(it->second);
+    }
+}
+
+void Audio_Manager::Print_Voice_Stats() const
+{
+    cout << "Voices: " << m_played << " played, " << m_coalesced << " coalesced, "
+         << m_stolen << " stolen, " << m_dropped << " dropped" << endl;
+}
+
+void Audio_Manager::Print_Latency_Stats() const
+{
+    cout << "Audio latency: buffer " << m_bufferSamples << " samples (" << m_bufferSamples * 1000.0 / m_rate << " ms)";
+    if (m_latencySamples > 0)
     {
-        Mix_PlayChannel(-1, m_sounds[name], 0);
+        cout << ", play to output avg " << m_latencyTotalUs / m_latencySamples / 1000.0
+             << " ms, max " << m_latencyMaxUs / 1000.0 << " ms over " << m_latencySamples << " sounds";
     }
+    cout << ", underruns " << m_underruns << endl;
 }
 
 void Audio_Manager::CleanUp()
 {
-    for (auto const& [name, chunk] : m_sounds)
+    for (Mix_Chunk*& chunk : m_sounds)
     {
-        Mix_FreeChunk(chunk);
+        if (chunk) Mix_FreeChunk(chunk);
+        chunk = nullptr;
     }
-    m_sounds.clear();
     Mix_Quit();
 }
\ No newline at end of file
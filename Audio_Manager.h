@@ -22,25 +22,100 @@
 #include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL_image.h>
 #include "map"
+#include <atomic>
 
 using namespace std;
 
+// Dense index into the Audio_Manager's sound slots, resolved once from a name
+struct Sound_Handle
+{
+    int index = -1;
+    bool IsValid() const { return index >= 0; }
+};
+
 class Audio_Manager
 {
 private:
     Audio_Manager() {}
     ~Audio_Manager() {}
 
-    map<string, Mix_Chunk*> m_sounds;
+    // How many mixer channels exist at all; mixing cost never grows past this
+    static const int VOICE_COUNT = 8;
+
+    struct Voice_Rule
+    {
+        int priority = 0;           // Higher survives stealing
+        int maxInstances = 2;
+    };
+
+    struct Voice
+    {
+        int sound = -1;             // Sound_Handle index, -1 when idle
+        int priority = 0;
+        Uint32 startFrame = 0;
+    };
+
+    map<string, Sound_Handle> m_handles;
+    vector<Mix_Chunk*> m_sounds;    // Indexed by Sound_Handle
+    vector<string> m_names;
+    vector<string> m_paths;         // Source file, empty if unknown
+    vector<Voice_Rule> m_rules;
+    vector<Uint32> m_lastPlayedFrame;
+
+    Voice m_voices[VOICE_COUNT];
+    Uint32 m_frame = 1;
+    int m_played = 0;
+    int m_coalesced = 0;
+    int m_stolen = 0;
+    int m_dropped = 0;
+
+    int Pick_Channel(int sound, int priority);
+
+    // Output device
+    int m_rate = 44100;
+    int m_bufferSamples = 2048;
+    int m_bufferIndex = 0;              // Into the candidate sizes, low latency mode only
+    bool m_lowLatency = false;
+    int m_underrunsAtCheck = 0;
+    Uint32 m_checkFrame = 0;
+
+    // Written by the mixer thread in the post-mix callback
+    atomic<Uint64> m_lastMixCounter{0};
+    atomic<int> m_underruns{0};
+    atomic<Uint64> m_pendingPlay{0};    // Counter at the first PlaySound not yet mixed
+    atomic<int> m_latencySamples{0};
+    atomic<Uint64> m_latencyTotalUs{0};
+    atomic<Uint32> m_latencyMaxUs{0};
+
+    bool Open_Device(int bufferSamples);
+    void Fall_Back();
+    static void Post_Mix(void* userdata, Uint8* stream, int length);
 public:
     static Audio_Manager& GetInstance()
     {
         static Audio_Manager instance;
         return instance;
     }
+    // With ER_LOW_LATENCY set, opens the smallest buffer that works and grows it again on underruns
     void Init();
     void LoadSound(const string& name, const string& path);
-    void PlaySound(const string& name);
+    void AddSound(const string& name, Mix_Chunk* chunk);
+    void SetPath(const string& name, const string& path);
+    vector<pair<string, string>> GetSources() const;
+
+    // Intern a name, valid before the sound itself is loaded
+    Sound_Handle GetHandle(const string& name);
+
+    // Priority decides who loses a channel when they run out; maxInstances caps one sound's overlap
+    void SetVoiceRule(Sound_Handle handle, int priority, int maxInstances);
+
+    // Call once per frame. Repeat plays of a sound within a frame collapse into one voice.
+    void BeginFrame();
+
+    void PlaySound(Sound_Handle handle);
+    void PlaySound(const string& name);     // Tooling only, resolves the name every call
+    void Print_Voice_Stats() const;
+    void Print_Latency_Stats() const;
     void CleanUp();
 };
 
@@ -0,0 +1,38 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_CONFIG_H
+#define ENDLESS_RUNNER_CONFIG_H
+
+#include <cstdlib>
+#include <cstring>
+
+// Launch options come from environment variables, since the game object is
+// created before main() gets to see any command line arguments.
+
+inline int Config_Int(const char* name, int fallback)
+{
+    const char* value = getenv(name);
+    return (value && *value) ? atoi(value) : fallback;
+}
+
+inline float Config_Float(const char* name, float fallback)
+{
+    const char* value = getenv(name);
+    return (value && *value) ? static_cast<float>(atof(value)) : fallback;
+}
+
+inline bool Config_Flag(const char* name)
+{
+    const char* value = getenv(name);
+    return value && *value && strcmp(value, "0") != 0;
+}
+
+inline const char* Config_String(const char* name, const char* fallback)
+{
+    const char* value = getenv(name);
+    return (value && *value) ? value : fallback;
+}
+
+#endif //ENDLESS_RUNNER_CONFIG_H
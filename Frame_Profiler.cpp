@@ -0,0 +1,64 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Frame_Profiler.h"
+#include <algorithm>
+
+namespace
+{
+    const char* PHASE_NAMES[] = { "Events", "Update", "Physics", "Collisions", "Render", "Render UI", "Present", "Sleep", "Frame" };
+}
+
+Frame_Profiler::Frame_Profiler()
+{
+    m_ticksToMs = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+void Frame_Profiler::Begin_Frame()
+{
+    fill(begin(m_current), end(m_current), 0.0f);
+    m_frameStart = SDL_GetPerformanceCounter();
+}
+
+void Frame_Profiler::End_Frame()
+{
+    uint32_t index = m_completed.load(memory_order_relaxed);
+    Frame_Sample& sample = m_frames[index % HISTORY_FRAMES];
+    copy(begin(m_current), end(m_current), sample.phaseMs);
+    Uint64 end = SDL_GetPerformanceCounter();
+    sample.frameMs = static_cast<float>((end - m_frameStart) * m_ticksToMs);
+    Trace_Recorder::GetInstance().Record(PHASE_NAMES[PHASE_COUNT], m_frameStart, end);
+
+    // Publish only after the slot is written
+    m_completed.store(index + 1, memory_order_release);
+}
+
+Frame_Profiler::Phase_Stats Frame_Profiler::Stats(int phase) const
+{
+    uint32_t completed = Completed();
+    int count = static_cast<int>(min<uint32_t>(completed, HISTORY_FRAMES));
+    if (count == 0) return { 0.0f, 0.0f, 0.0f };
+
+    float values[HISTORY_FRAMES];
+    for (int i = 0; i < count; ++i)
+    {
+        const Frame_Sample& sample = Frame(completed - 1 - i);
+        values[i] = (phase < PHASE_COUNT) ? sample.phaseMs[phase] : sample.frameMs;
+    }
+
+    Phase_Stats stats;
+    nth_element(values, values + count / 2, values + count);
+    stats.p50 = values[count / 2];
+    int p99Index = min(count - 1, count * 99 / 100);
+    nth_element(values, values + p99Index, values + count);
+    stats.p99 = values[p99Index];
+    stats.max = *max_element(values, values + count);
+    return stats;
+}
+
+const char* Frame_Profiler::Phase_Name(int phase)
+{
+    if (phase < 0 || phase > PHASE_COUNT) phase = PHASE_COUNT;
+    return PHASE_NAMES[phase];
+}
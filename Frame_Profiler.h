@@ -0,0 +1,110 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_FRAME_PROFILER_H
+#define ENDLESS_RUNNER_FRAME_PROFILER_H
+
+#include "Trace_Recorder.h"
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+enum class Profile_Phase : uint8_t { EVENTS, UPDATE, PHYSICS, COLLISIONS, RENDER, RENDER_UI, PRESENT, SLEEP, COUNT };
+
+// Per-phase frame timings. The game thread fills one sample per frame into a fixed ring;
+// readers (the overlay) only ever look at completed frames, so no locks are involved.
+class Frame_Profiler
+{
+public:
+    static const int PHASE_COUNT = static_cast<int>(Profile_Phase::COUNT);
+    static const int HISTORY_FRAMES = 240;
+
+    struct Frame_Sample
+    {
+        float phaseMs[PHASE_COUNT];
+        float frameMs;
+    };
+
+    struct Phase_Stats
+    {
+        float p50;
+        float p99;
+        float max;
+    };
+private:
+    Frame_Profiler();
+
+    Frame_Sample m_frames[HISTORY_FRAMES];
+    atomic<uint32_t> m_completed{0};    // Frames finished so far; frame i lives in slot i % HISTORY_FRAMES
+
+    float m_current[PHASE_COUNT] = {};
+    static inline thread_local int t_currentPhase = PHASE_COUNT;   // Innermost open scope on this thread
+    static inline thread_local Uint64 t_childTicks = 0;            // Spent in scopes closed inside the innermost open one
+    Uint64 m_frameStart = 0;
+    double m_ticksToMs;
+public:
+    static Frame_Profiler& GetInstance()
+    {
+        static Frame_Profiler instance;
+        return instance;
+    }
+
+    void Begin_Frame();
+    void End_Frame();
+    static int Current_Phase() { return t_currentPhase; }
+    static int Enter_Phase(Profile_Phase phase) { int previous = t_currentPhase; t_currentPhase = static_cast<int>(phase); return previous; }
+    static void Leave_Phase(int previous) { t_currentPhase = previous; }
+    static Uint64 Swap_Child_Ticks(Uint64 ticks) { Uint64 previous = t_childTicks; t_childTicks = ticks; return previous; }
+    void Add(Profile_Phase phase, Uint64 ticks) { m_current[static_cast<int>(phase)] += static_cast<float>(ticks * m_ticksToMs); }
+
+    uint32_t Completed() const { return m_completed.load(memory_order_acquire); }
+    const Frame_Sample& Frame(uint32_t index) const { return m_frames[index % HISTORY_FRAMES]; }
+
+    // Over the frames in the ring. Pass PHASE_COUNT for whole-frame times.
+    Phase_Stats Stats(int phase) const;
+    static const char* Phase_Name(int phase);
+};
+
+// Adds the time between construction and destruction to a phase, minus the time spent in scopes
+// nested inside it, so phases are exclusive and never add up to more than the frame (UPDATE is the
+// update without PHYSICS and COLLISIONS). Repeated scopes accumulate. When tracing is on, each scope
+// is also recorded as a trace event, with its full nested duration.
+class Profile_Scope
+{
+private:
+    Profile_Phase m_phase;
+    int m_previous;
+    Uint64 m_outerChildTicks;
+    Uint64 m_start;
+public:
+    explicit Profile_Scope(Profile_Phase phase)
+        : m_phase(phase), m_previous(Frame_Profiler::Enter_Phase(phase)), m_outerChildTicks(Frame_Profiler::Swap_Child_Ticks(0)),
+          m_start(SDL_GetPerformanceCounter()) {}
+    ~Profile_Scope()
+    {
+        Frame_Profiler::Leave_Phase(m_previous);
+        Uint64 end = SDL_GetPerformanceCounter();
+        Uint64 children = Frame_Profiler::Swap_Child_Ticks(m_outerChildTicks + (end - m_start));
+        Frame_Profiler::GetInstance().Add(m_phase, end - m_start - children);
+        Trace_Recorder::GetInstance().Record(Frame_Profiler::Phase_Name(static_cast<int>(m_phase)), m_start, end);
+    }
+};
+
+// Configure with -DER_PROFILER=OFF and all of these compile to nothing
+#ifdef ER_PROFILER_ENABLED
+#define ER_PROFILE_CONCAT_(a, b) a##b
+#define ER_PROFILE_CONCAT(a, b) ER_PROFILE_CONCAT_(a, b)
+#define ER_PROFILE_SCOPE(phase) Profile_Scope ER_PROFILE_CONCAT(er_profile_scope_, __LINE__)(Profile_Phase::phase)
+#define ER_PROFILE_BEGIN_FRAME() Frame_Profiler::GetInstance().Begin_Frame()
+#define ER_PROFILE_END_FRAME() Frame_Profiler::GetInstance().End_Frame()
+#else
+#define ER_PROFILE_SCOPE(phase) ((void)0)
+#define ER_PROFILE_BEGIN_FRAME() ((void)0)
+#define ER_PROFILE_END_FRAME() ((void)0)
+#endif
+
+
+#endif //ENDLESS_RUNNER_FRAME_PROFILER_H
@@ -6,7 +6,47 @@
 
 // helper
 
-inline void render_text(SDL_Renderer* renderer, TTF_Font* font, const string& text, int x, int y, SDL_Color color = { 200, 200, 200, 255 })
+inline vector<Texture_Handle> Resolve_Textures(initializer_list<string> names)
+{
+    vector<Texture_Handle> handles;
+    for (const string& name : names)
+    {
+        handles.push_back(Asset_Manager::GetInstance().GetHandle(name));
+    }
+    return handles;
+}
+
+// Parks an entity's body and keeps the object around for the next spawn
+template<typename T>
+inline void Release_To_Pool(unique_ptr<T>& object, vector<unique_ptr<T>>& pool)
+{
+    object->Deactivate();
+    pool.push_back(std::move(object));
+}
+
+template<typename T, typename Predicate>
+inline void Release_If(deque<unique_ptr<T>>& live, vector<unique_ptr<T>>& pool, Predicate shouldRelease)
+{
+    auto kept = live.begin();
+    for (auto& object : live)
+    {
+        if (shouldRelease(*object)) Release_To_Pool(object, pool);
+        else *kept++ = std::move(object);
+    }
+    live.erase(kept, live.end());
+}
+
+template<typename T>
+inline void Release_All(deque<unique_ptr<T>>& live, vector<unique_ptr<T>>& pool)
+{
+    for (auto& object : live)
+    {
+        Release_To_Pool(object, pool);
+    }
+    live.clear();
+}
+
+void render_text(SDL_Renderer* renderer, TTF_Font* font, const string& text, int x, int y, SDL_Color color)
 {
     if (!font) return;
 
@@ -26,10 +66,36 @@ inline void render_text(SDL_Renderer* renderer, TTF_Font* font, const string& te
     SDL_FreeSurface(surface);
 }
 
+namespace
+{
+    const float STAR_LAYER_SPEEDS[] = {0.15f, 0.25f, 0.50f}; // Far, middle, near layers
+
+    // SDL_Delay can overshoot by a millisecond or more, so it only covers the bulk of the wait.
+    // The last stretch is slept off in 1 ms steps, or with spin set, spun out on the performance
+    // counter so frames start on time; that keeps a core busy for ~2 ms of every frame.
+    void Wait_Until(Uint64 deadline, bool spin)
+    {
+        const Uint64 frequency = SDL_GetPerformanceFrequency();
+        const Uint64 marginCounts = frequency * (spin ? 2 : 1) / 1000;
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now + marginCounts < deadline)
+        {
+            SDL_Delay(static_cast<Uint32>((deadline - now - marginCounts) * 1000 / frequency));
+        }
+        while (SDL_GetPerformanceCounter() < deadline)
+        {
+            if (!spin) SDL_Delay(1);
+        }
+    }
+}
+
 // Functions
 
 Game::Game()
 {
+    Alloc_Tracker::GetInstance().Install_SDL_Hooks();
+
+    m_startupCounter = SDL_GetPerformanceCounter();
     srand(time(0));
 
     // SDL init
@@ -44,13 +110,29 @@ Game::Game()
         throw runtime_error("SDL_ttf could not initialize! TTF_Error: " + string(TTF_GetError()));
     }
 
-    font_large = TTF_OpenFont(FONT , 48);
+    // Everything ships in one packed file when it's there, loose files are the fallback
+    const char* archivePath = Config_String("ER_ASSET_ARCHIVE", "assets.pak");
+    if (!Asset_Archive::GetInstance().Open(archivePath))
+    {
+        cout << "No asset archive at " << archivePath << ", loading loose files" << endl;
+    }
+
+    // Decoded pixels from earlier launches, so a warm start only pays for the upload
+    if (!Config_Flag("ER_NO_TEXTURE_CACHE"))
+    {
+        Texture_Cache::GetInstance().Open(Config_String("ER_TEXTURE_CACHE_DIR", "texture_cache"));
+    }
+
+    // TTF reads glyphs lazily from its stream, which is fine since the archive stays mapped
+    SDL_RWops* packedFont = Asset_Archive::GetInstance().Open_Entry("font");
+    font_large = packedFont ? TTF_OpenFontRW(packedFont, 1, 48) : TTF_OpenFont(FONT , 48);
     if (!font_large)
     {
         cerr << "Failed to load font_large: " << TTF_GetError() << endl;
     }
 
-    font_regular = TTF_OpenFont(FONT , 24);
+    packedFont = Asset_Archive::GetInstance().Open_Entry("font");
+    font_regular = packedFont ? TTF_OpenFontRW(packedFont, 1, 24) : TTF_OpenFont(FONT , 24);
     if (!font_regular)
     {
         cerr << "Failed to load font_regular: " << TTF_GetError() << endl;
@@ -80,9 +162,22 @@ Game::Game()
         throw runtime_error("Renderer could not be created! SDL_Error: " + string(SDL_GetError()));
     }
 
-    Load_Scores();
-    LoadWallet();
+    // Textures over the budget are evicted least recently used first and reloaded on demand
+    Asset_Manager::GetInstance().SetRenderer(renderer);
+    Asset_Manager::GetInstance().SetBudget(static_cast<size_t>(Config_Int("ER_TEXTURE_BUDGET_MB", 0)) * 1024 * 1024);
+    Asset_Manager::GetInstance().SetLoader(&m_loader);
+
     InitializeSkins();
+    m_profilePath = Config_String("ER_PROFILE_PATH", "profile.bin");
+    Load_Profile();
+
+    m_history.Open(Config_String("ER_HISTORY_DIR", "history"));
+    m_panelScores = m_history.Top(5);
+
+    m_stress.Configure();
+    m_input.Configure();
+    m_spinWait = Config_Flag("ER_LOW_LATENCY") || Config_Flag("ER_INPUT_LATENCY");
+    m_autoplaySeconds = Config_Float("ER_AUTOPLAY_SECONDS", 0.0f);
 
     // box2d initializations
     b2WorldDef worldDef = b2DefaultWorldDef();
@@ -92,112 +187,488 @@ Game::Game()
     // Window size
     SDL_GetWindowSize(window, &SCREEN_WIDTH, &SCREEN_HEIGHT);
 
-    // Textures
-    Load_Assets();
+    // Budget matches Run()'s 60 fps target
+    m_telemetry.Init(window, renderer, 1000.0f / 60.0f);
+    m_sparkPool = m_particles.Add_Pool(Texture_Handle(), PARTICLE_CAPACITY);
 
-    SDL_Texture* coinTexture = Asset_Manager::GetInstance().GetTexture("Coin");
-    if (coinTexture)
+    // The mixer has to be open before sounds are decoded, so they get converted to its format
+    Audio_Manager::GetInstance().Init();
+
+    // Tracks stream from disk on the music thread, nothing is decoded up front
+    m_menuMusicPath = Config_String("ER_MENU_MUSIC", "D://MUSIC//menu.ogg");
+    m_gameMusicPath = Config_String("ER_GAME_MUSIC", "D://MUSIC//gameplay.ogg");
+    if (!Config_Flag("ER_NO_MUSIC"))
     {
-        m_uiCoinFrameCount = 10;
-        SDL_QueryTexture(coinTexture, NULL, NULL, &m_uiCoinFrameWidth, &m_uiCoinFrameHeight);
-        m_uiCoinFrameWidth /= m_uiCoinFrameCount;
+        Music_Player::GetInstance().Init(Config_Float("ER_MUSIC_VOLUME", 0.5f));
     }
 
+    // Textures and sounds decode in the background, Run() shows a loading screen until they're in
+    Resolve_Handles();
+    Load_Assets();
 
     // BackGround
     GenerateStars();
 
+    Build_UI();
+}
+
+void Game::Update_Loading()
+{
+    const int uploadsPerFrame = Config_Int("ER_UPLOADS_PER_FRAME", 4);
+    if (m_loader.Pump(renderer, uploadsPerFrame))
+    {
+        Finish_Loading();
+        m_current_State = STATE::MAIN_MENU;
+
+        // Stress and scripted runs skip the menu
+        if (m_stress.Active() || m_autoplaySeconds > 0.0f)
+        {
+            Reset_Game();
+            m_current_State = STATE::PLAYING;
+        }
+    }
+}
+
+void Game::Render_Loading()
+{
+    SDL_SetRenderDrawColor(renderer, 10, 20, 40, 255);
+    SDL_RenderClear(renderer);
+
+    RenderStarfield();
+
+    render_text(renderer, font_large, "Endless Runner", SCREEN_WIDTH / 2 - 150, 100);
+
+    SDL_Rect barRect = { SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2, 400, 30 };
+    SDL_Rect fillRect = barRect;
+    fillRect.w = static_cast<int>(barRect.w * m_loader.Progress());
+
+    SDL_SetRenderDrawColor(renderer, 0, 255, 100, 255);
+    SDL_RenderFillRect(renderer, &fillRect);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawRect(renderer, &barRect);
+
+    render_text(renderer, font_regular, "Loading...", SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 + 40);
+}
+
+void Game::Finish_Loading()
+{
     // Objects
     m_Player = make_unique<Player>(World_Id);
+    m_Player->Set_Coyote_Time(m_input.Coyote_Seconds());
     Generate_Initial_Ground();
 
-    // Sounds
-    Audio_Manager::GetInstance().Init();
-    Audio_Manager::GetInstance().LoadSound("jump", "D://SOUND_EFFECTS//qubodup-cfork-ccby3-jump.ogg");
-    Audio_Manager::GetInstance().LoadSound("crash", "D://SOUND_EFFECTS//zoom3.wav");
-    Audio_Manager::GetInstance().LoadSound("UI_click", "D://SOUND_EFFECTS//UI//switch9.ogg");
-    Audio_Manager::GetInstance().LoadSound("collect_Coin", "D://SOUND_EFFECTS//retro-game-coin-pickup-jam-fx-1-00-03.mp3");
-    Audio_Manager::GetInstance().LoadSound("collect_PowerUp", "D://SOUND_EFFECTS//video-game-bonus-retro-sparkle-gamemaster-audio-lower-tone-1-00-00.mp3");
+    double interactiveMs = (SDL_GetPerformanceCounter() - m_startupCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    m_loader.Print_Report(m_firstFrameMs, interactiveMs);
+    m_telemetry.Set_Load_Time(interactiveMs);
+    Texture_Cache::GetInstance().Print_Stats();
+    Asset_Manager::GetInstance().Print_Residency();
+
+    // Started only now so a reload can't race the loader's own upload of the same asset
+    if (Config_Flag("ER_HOT_RELOAD"))
+    {
+        m_watcher.Start();
+    }
 }
 
 void Game::Run()
 {
     running = true;
-    m_current_State = STATE::MAIN_MENU;
+    m_current_State = m_Player ? STATE::MAIN_MENU : STATE::LOADING;
 
-    const int TARGET_FPS = 60;
-    const float FRAME_DELAY = 1000.0f / TARGET_FPS;
     float timeStep = 1.0f / TARGET_FPS;
-    Uint32 frameStart;
+    const Uint64 framePeriod = SDL_GetPerformanceFrequency() / TARGET_FPS;
+    Uint64 nextFrame = SDL_GetPerformanceCounter();
+
+    ER_TRACE_THREAD("Game");
 
     while (running)
     {
-        frameStart = SDL_GetTicks();
+        ER_PROFILE_BEGIN_FRAME();
+        Alloc_Tracker::GetInstance().Begin_Frame();
+
+        // The wait for the next frame happens here, before input is polled, rather than after
+        // presenting: a press during the wait is then seen by the very next tick instead of
+        // sitting in the queue for a whole sleep. Scripted runs go as fast as the machine allows,
+        // the simulation steps are fixed anyway.
+        if (m_autoplaySeconds <= 0.0f)
+        {
+            ER_PROFILE_SCOPE(SLEEP);
+            Wait_Until(nextFrame, m_spinWait);
+        }
+        // A frame that ran long moves the schedule instead of being caught up on with short frames
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        nextFrame = frameStart > nextFrame + framePeriod ? frameStart + framePeriod : nextFrame + framePeriod;
+
+        Asset_Manager::GetInstance().BeginFrame();
+        m_loader.Pump_Reloads(renderer, RELOAD_UPLOADS_PER_FRAME);
+        Audio_Manager::GetInstance().BeginFrame();
+        Update_Music();
+        m_watcher.Apply(renderer);
 
         SDL_Event event;
-        while (SDL_PollEvent(&event))
         {
-            if (event.type == SDL_QUIT)
+            ER_PROFILE_SCOPE(EVENTS);
+            while (SDL_PollEvent(&event))
             {
-                running = false;
-            }
+                if (event.type == SDL_QUIT)
+                {
+                    running = false;
+                }
+                if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F1)
+                {
+                    m_showProfiler = !m_showProfiler;
+                }
+                if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F2)
+                {
+                    // Written between frames, so the stall never lands inside a traced frame
+                    m_flushTrace = true;
+                }
 
-            switch (m_current_State)
-            {
-                case STATE::MAIN_MENU:
-                    HandleEvents_MainMenu(event);
-                    break;
-                case STATE::PLAYING:
-                    HandleEvents_Playing(event);
-                    break;
-                case STATE::GAME_OVER:
-                    HandleEvents_GameOver(event);
-                    break;
-                case STATE::SHOP:
-                    HandleEvents_Shop(event);
-                    break;
+                switch (m_current_State)
+                {
+                    case STATE::LOADING:
+                        break;
+                    case STATE::MAIN_MENU:
+                        HandleEvents_MainMenu(event);
+                        break;
+                    case STATE::PLAYING:
+                        HandleEvents_Playing(event);
+                        break;
+                    case STATE::GAME_OVER:
+                        HandleEvents_GameOver(event);
+                        break;
+                    case STATE::SHOP:
+                        HandleEvents_Shop(event);
+                        break;
+                }
             }
         }
 
         switch (m_current_State)
         {
+            case STATE::LOADING:
+                Update_Loading();
+                Render_Loading();
+                break;
+
             case STATE::MAIN_MENU:
                 Render_MainMenu();
                 break;
 
             case STATE::PLAYING:
-                Update_Playing(timeStep);
+            {
+                {
+                    ER_PROFILE_SCOPE(UPDATE);
+                    if (m_autoplaySeconds > 0.0f) Update_Autoplay();
+                    Update_Playing(timeStep);
+                }
+                ER_PROFILE_SCOPE(RENDER);
                 Render_Playing();
                 break;
+            }
 
             case STATE::GAME_OVER:
+            {
+                {
+                    // The crash keeps playing out behind the menu
+                    ER_PROFILE_SCOPE(UPDATE);
+                    m_particles.Update(timeStep);
+                }
+                ER_PROFILE_SCOPE(RENDER);
                 Render_GameOver();
                 break;
+            }
             case STATE::SHOP:
                 Render_Shop();
                 break;
         }
-        SDL_RenderPresent(renderer);
+        Render_Profiler();
+        {
+            ER_PROFILE_SCOPE(PRESENT);
+            SDL_RenderPresent(renderer);
+        }
+        m_input.Frame_Presented();
+
+        if (m_firstFrameMs < 0.0)
+        {
+            m_firstFrameMs = (SDL_GetPerformanceCounter() - m_startupCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+        }
+
+        ER_PROFILE_END_FRAME();
+        Alloc_Tracker::GetInstance().End_Frame(m_current_State == STATE::PLAYING);
+
+        Run_Telemetry::Peaks entities;
+        entities.obstacles = m_Obstacles.size();
+        entities.coins = m_coins.size();
+        entities.powerUps = m_powerUps.size();
+        entities.ground = m_Ground_Segments.size();
+        entities.residentTextureBytes = Asset_Manager::GetInstance().GetResidentBytes();
+        m_telemetry.Record_Frame(m_current_State == STATE::PLAYING, entities);
+
+        if (m_stress.Active() && m_current_State == STATE::PLAYING && !m_stress.Record_Frame(Live_Entity_Count()))
+        {
+            running = false;
+        }
 
-        int frameTime = SDL_GetTicks() - frameStart;
-        if (FRAME_DELAY > frameTime)
+        if (m_autoplaySeconds > 0.0f && m_current_State != STATE::LOADING)
         {
-            SDL_Delay(FRAME_DELAY - frameTime);
+            m_autoplayElapsed += timeStep;
+            if (m_autoplayElapsed >= m_autoplaySeconds)
+            {
+                running = false;
+            }
+            else if (m_current_State == STATE::GAME_OVER)
+            {
+                Finish_Run();
+                Reset_Game();
+                m_current_State = STATE::PLAYING;
+            }
+        }
+
+        if (m_flushTrace)
+        {
+            Trace_Recorder::GetInstance().Flush();
+            m_flushTrace = false;
+        }
+    }
+
+    // Quitting from game over still counts the run
+    Finish_Run();
+    m_watcher.Stop();
+    m_profileWriter.Stop();
+    m_stress.Stop();
+    m_telemetry.Stop();
+    m_history.Flush();
+    Music_Player::GetInstance().Shutdown();
+    Audio_Manager::GetInstance().Print_Voice_Stats();
+    Audio_Manager::GetInstance().Print_Latency_Stats();
+    m_input.Print_Latency_Stats();
+    Asset_Manager::GetInstance().Print_Residency();
+    Asset_Manager::GetInstance().SetLoader(nullptr);
+    Asset_Manager::GetInstance().CleanUp();
+    Trace_Recorder::GetInstance().Flush();
+    Alloc_Tracker::GetInstance().Print_Report();
+}
+
+void Game::Render_Profiler()
+{
+#ifdef ER_PROFILER_ENABLED
+    if (!m_showProfiler) return;
+
+    const Frame_Profiler& profiler = Frame_Profiler::GetInstance();
+    const int ROW_HEIGHT = 34;
+    const int GRAPH_WIDTH = 240;
+    const int rows = Frame_Profiler::PHASE_COUNT + 1;   // Every phase, then the whole frame
+    const int panelX = SCREEN_WIDTH - 620;
+    const int panelY = 10;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+#ifdef ER_ALLOC_TRACKER_ENABLED
+    const int textRows = 1;     // Allocation counts under the graphs
+#else
+    const int textRows = 0;
+#endif
+    SDL_Rect panel = { panelX, panelY, 610, (rows + textRows) * ROW_HEIGHT + 10 };
+    SDL_RenderFillRect(renderer, &panel);
+
+    uint32_t completed = profiler.Completed();
+    int frames = static_cast<int>(min<uint32_t>(completed, GRAPH_WIDTH));
+
+    for (int row = 0; row < rows; ++row)
+    {
+        Frame_Profiler::Phase_Stats stats = profiler.Stats(row);
+        int rowY = panelY + 5 + row * ROW_HEIGHT;
+
+        char label[96];
+        snprintf(label, sizeof(label), "%-10s p50 %5.2f  p99 %5.2f  max %5.2f", Frame_Profiler::Phase_Name(row), stats.p50, stats.p99, stats.max);
+        render_text(renderer, font_regular, label, panelX + 5, rowY, { 220, 220, 220, 255 });
+
+        // Rolling graph, newest on the right, scaled to the row's max
+        int graphX = panelX + 610 - GRAPH_WIDTH - 5;
+        float scale = (stats.max > 0.0f) ? (ROW_HEIGHT - 4) / stats.max : 0.0f;
+        SDL_SetRenderDrawColor(renderer, row == rows - 1 ? 255 : 0, 200, 100, 255);
+        for (int i = 0; i < frames; ++i)
+        {
+            const Frame_Profiler::Frame_Sample& sample = profiler.Frame(completed - frames + i);
+            float value = (row < Frame_Profiler::PHASE_COUNT) ? sample.phaseMs[row] : sample.frameMs;
+            int height = static_cast<int>(value * scale);
+            SDL_RenderDrawLine(renderer, graphX + i, rowY + ROW_HEIGHT - 2, graphX + i, rowY + ROW_HEIGHT - 2 - height);
         }
     }
+
+#ifdef ER_ALLOC_TRACKER_ENABLED
+    Alloc_Tracker::Counters allocs = Alloc_Tracker::GetInstance().Last_Frame_Total();
+    char allocLabel[96];
+    snprintf(allocLabel, sizeof(allocLabel), "Allocations last frame: %u (%llu bytes)", allocs.count, (unsigned long long)allocs.bytes);
+    render_text(renderer, font_regular, allocLabel, panelX + 5, panelY + 5 + rows * ROW_HEIGHT, { 220, 220, 220, 255 });
+#endif
+#endif
+}
+
+void Game::Update_Music()
+{
+    // Menus share one track, runs get the other
+    string wanted;
+    if (m_current_State == STATE::PLAYING) wanted = "music_game";
+    else if (m_current_State != STATE::LOADING) wanted = "music_menu";
+
+    if (wanted == m_currentMusic) return;
+    m_currentMusic = wanted;
+
+    if (wanted.empty()) Music_Player::GetInstance().Stop(MUSIC_CROSSFADE_SECONDS);
+    else Music_Player::GetInstance().Play(wanted, wanted == "music_game" ? m_gameMusicPath : m_menuMusicPath, MUSIC_CROSSFADE_SECONDS);
 }
 
 void Game::Generate_Initial_Ground()
 {
     float currentX = 0.0f;
     // Create enough segments to fill about two screens worth of ground
-    SDL_Texture* tex = Asset_Manager::GetInstance().GetTexture("Ground_Sand");
-
     for (int i = 0; i < 3; ++i)
     {
-        m_Ground_Segments.push_back(make_unique<Scenery>(World_Id, currentX, tex));
         // The next segment will start at the right edge of this one
-        currentX = m_Ground_Segments.back()->Get_Right_EdgeX();
+        currentX = Spawn_Ground(currentX, m_groundTexture)->Get_Right_EdgeX();
+    }
+}
+
+Scenery* Game::Spawn_Ground(float startX, Texture_Handle texture)
+{
+    ER_TRACE_SCOPE("Spawn_Ground");
+    if (m_groundPool.empty())
+    {
+        m_Ground_Segments.push_back(make_unique<Scenery>(World_Id, startX, texture));
+    }
+    else
+    {
+        m_Ground_Segments.push_back(std::move(m_groundPool.back()));
+        m_groundPool.pop_back();
+        m_Ground_Segments.back()->Respawn(startX, texture);
+    }
+    return m_Ground_Segments.back().get();
+}
+
+Obstacle* Game::Spawn_Obstacle(float x, float y, float width, float height, Texture_Handle texture, Obstacle_Kind kind)
+{
+    ER_TRACE_SCOPE("Spawn_Obstacle");
+    if (m_obstaclePool.empty())
+    {
+        m_Obstacles.push_back(make_unique<Obstacle>(World_Id, x, y, width, height, texture));
+    }
+    else
+    {
+        m_Obstacles.push_back(std::move(m_obstaclePool.back()));
+        m_obstaclePool.pop_back();
+        m_Obstacles.back()->Respawn(x, y, width, height, texture);
+    }
+    m_Obstacles.back()->Set_Kind(kind);
+    return m_Obstacles.back().get();
+}
+
+PowerUp* Game::Spawn_PowerUp(PowerUpType type, float x, float y)
+{
+    ER_TRACE_SCOPE("Spawn_PowerUp");
+    if (m_powerUpPool.empty())
+    {
+        m_powerUps.push_back(make_unique<PowerUp>(World_Id, type, x, y));
+    }
+    else
+    {
+        m_powerUps.push_back(std::move(m_powerUpPool.back()));
+        m_powerUpPool.pop_back();
+        m_powerUps.back()->Respawn(type, x, y);
+    }
+    return m_powerUps.back().get();
+}
+
+Coin* Game::Spawn_Coin(float x, float y)
+{
+    ER_TRACE_SCOPE("Spawn_Coin");
+    if (m_coinPool.empty())
+    {
+        m_coins.push_back(make_unique<Coin>(World_Id, x, y));
+    }
+    else
+    {
+        m_coins.push_back(std::move(m_coinPool.back()));
+        m_coinPool.pop_back();
+        m_coins.back()->Respawn(x, y);
+    }
+    return m_coins.back().get();
+}
+
+void Game::Release_Entities()
+{
+    Release_All(m_Obstacles, m_obstaclePool);
+    Release_All(m_powerUps, m_powerUpPool);
+    Release_All(m_coins, m_coinPool);
+}
+
+size_t Game::Live_Entity_Count() const
+{
+    return m_Obstacles.size() + m_powerUps.size() + m_coins.size();
+}
+
+void Game::Update_Stress()
+{
+    // The normal cleanup drops one obstacle a frame and no coins or power-ups, which can't keep up here
+    Release_If(m_Obstacles, m_obstaclePool, [this](Obstacle& obstacle) { return obstacle.Get_Right_EdgeX() < cameraX; });
+    Release_If(m_coins, m_coinPool, [this](Coin& coin) { return coin.get_position().x * PIXELS_PER_METER < cameraX - 50.0f; });
+    Release_If(m_powerUps, m_powerUpPool, [this](PowerUp& powerUp) { return powerUp.get_position().x * PIXELS_PER_METER < cameraX - 50.0f; });
+
+    int target = m_stress.Target_Entities();
+    if (target == 0) return;
+
+    // Held entities are spread over three screens from the camera on, so as many scroll
+    // off the left each frame as get topped up on the right
+    const float spacing = SCREEN_WIDTH * 3.0f / target;
+    if (m_stressCursorX < cameraX) m_stressCursorX = cameraX;
+
+    const int bandHeight = max(1, SCREEN_HEIGHT - 400);
+    for (size_t live = Live_Entity_Count(); live < static_cast<size_t>(target); ++live)
+    {
+        float x = m_stressCursorX;
+        float y = 60.0f + static_cast<float>(rand() % bandHeight);
+        int pick = rand() % 10;
+
+        if (pick < 5)
+        {
+            Spawn_Coin(x / PIXELS_PER_METER, y / PIXELS_PER_METER);
+        }
+        else if (pick < 9 && !small_obstacle_skins.empty())
+        {
+            Spawn_Obstacle(x, y, 70.0f, 50.0f, small_obstacle_skins[rand() % small_obstacle_skins.size()], Obstacle_Kind::SMALL);
+        }
+        else
+        {
+            Spawn_PowerUp(static_cast<PowerUpType>(rand() % 2), x / PIXELS_PER_METER, y / PIXELS_PER_METER);
+        }
+        m_stressCursorX += spacing;
+    }
+}
+
+void Game::Update_Autoplay()
+{
+    // Jumps at the nearest obstacle ahead and double-jumps over tall ones. It dies now and
+    // then, which is fine: the run restarts and death, scoring and reset get exercised too.
+    b2Vec2 playerPos = m_Player->get_position();
+    for (const auto& obstacle : m_Obstacles)
+    {
+        b2Vec2 obstaclePos = obstacle->get_position();
+        float halfWidth = obstacle->GetWidthMeters() / 2.0f;
+        if (obstaclePos.x + halfWidth < playerPos.x) continue;
+
+        float gap = obstaclePos.x - halfWidth - playerPos.x;
+        if (!m_Player->Can_Jump()) break;
+
+        if (gap < 3.0f && m_Player->Is_On_Ground(World_Id))
+        {
+            m_Player->Jump();
+        }
+        else if (gap < 1.0f && obstacle->Get_Kind() == Obstacle_Kind::TALL && !m_Player->Is_On_Ground(World_Id))
+        {
+            m_Player->Jump();
+        }
+        break;
     }
 }
 
@@ -207,19 +678,20 @@ void Game::Update_Ground()
     Scenery* lastSegment = m_Ground_Segments.back().get();
     if (lastSegment->Get_Right_EdgeX() < cameraX + SCREEN_WIDTH + 200) // +200 for a buffer
     {
-        SDL_Texture* tex = Asset_Manager::GetInstance().GetTexture("Ground_Sand");
         float nextX = lastSegment->Get_Right_EdgeX();
-        m_Ground_Segments.push_back(make_unique<Scenery>(World_Id, nextX, tex));
+        Spawn_Ground(nextX, m_groundTexture);
     }
 
     // If the right edge of the first ground segment is off the left side of the screen, remove it.
     Scenery* firstSegment = m_Ground_Segments.front().get();
     if (firstSegment->Get_Right_EdgeX() < cameraX)
     {
+        Release_To_Pool(m_Ground_Segments.front(), m_groundPool);
         m_Ground_Segments.pop_front();
     }
     if (!m_Obstacles.empty() && m_Obstacles.front()->Get_Right_EdgeX() < cameraX)
     {
+        Release_To_Pool(m_Obstacles.front(), m_obstaclePool);
         m_Obstacles.pop_front();
     }
 //    if (!m_powerUps.empty() && m_powerUps.front()->get_position().x < cameraX)
@@ -258,9 +730,9 @@ void Game::Update_Spawning(float deltaTime)
                 if (skins.empty()) break;
 
                 int skinIndex = rand() % skins.size();
-                SDL_Texture* tex = Asset_Manager::GetInstance().GetTexture(skins[skinIndex]);
+                Texture_Handle tex = skins[skinIndex];
 
-                m_Obstacles.push_back(std::make_unique<Obstacle>(World_Id, spawnX, spawnY, width, height, tex));
+                Spawn_Obstacle(spawnX, spawnY, width, height, tex, Obstacle_Kind::SMALL);
                 break;
             }
             case 1: // Tall Obstacle (requires double jump)
@@ -272,8 +744,8 @@ void Game::Update_Spawning(float deltaTime)
                 if (skins.empty()) break;
 
                 int skinIndex = rand() % skins.size();
-                SDL_Texture* tex = Asset_Manager::GetInstance().GetTexture(skins[skinIndex]);
-                m_Obstacles.push_back(std::make_unique<Obstacle>(World_Id, spawnX, spawnY, width, height, tex));
+                Texture_Handle tex = skins[skinIndex];
+                Spawn_Obstacle(spawnX, spawnY, width, height, tex, Obstacle_Kind::TALL);
                 break;
             }
             case 2: // Wide Obstacle (requires precise jump timing)
@@ -285,8 +757,8 @@ void Game::Update_Spawning(float deltaTime)
                 if (skins.empty()) break;
 
                 int skinIndex = rand() % skins.size();
-                SDL_Texture* tex = Asset_Manager::GetInstance().GetTexture(skins[skinIndex]);
-                m_Obstacles.push_back(std::make_unique<Obstacle>(World_Id, spawnX, spawnY, width, height, tex));
+                Texture_Handle tex = skins[skinIndex];
+                Spawn_Obstacle(spawnX, spawnY, width, height, tex, Obstacle_Kind::WIDE);
                 break;
             }
         }
@@ -344,7 +816,7 @@ void Game::Update_Spawning(float deltaTime)
                 } else {
                     PowerUpType type = static_cast<PowerUpType>(rand() % 2);
                     std::cout << "Spawning PowerUp (meters): " << powerUpPos.x << ", " << powerUpPos.y << std::endl;
-                    m_powerUps.push_back(std::make_unique<PowerUp>(World_Id, type, powerUpPos.x, powerUpPos.y));
+                    Spawn_PowerUp(type, powerUpPos.x, powerUpPos.y);
                 }
             }
         }
@@ -375,7 +847,7 @@ void Game::Update_Spawning(float deltaTime)
                 float coinX_meters = coinX_px / PIXELS_PER_METER;
                 float spawnY_meters = spawnY_px / PIXELS_PER_METER;
 
-                m_coins.push_back(std::make_unique<Coin>(World_Id, coinX_meters, spawnY_meters));
+                Spawn_Coin(coinX_meters, spawnY_meters);
             }
         }
 
@@ -397,7 +869,7 @@ void Game::Update_Spawning(float deltaTime)
         float randomFraction = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
         float randomTime = currentMinDelay + (randomFraction * delayRange);
 
-        m_Obstacle_Spawn_Timer = randomTime;
+        m_Obstacle_Spawn_Timer = randomTime / m_stress.Spawn_Factor();
     }
 }
 
@@ -428,6 +900,8 @@ void Game::Update_Score()
 
 void Game::Render_UI()
 {
+    ER_PROFILE_SCOPE(RENDER_UI);
+
     if (m_current_State == STATE::PLAYING)
     {
         string scoreText = "Score: " + to_string(m_score);
@@ -484,10 +958,12 @@ void Game::Render_UI()
     }
 
 
-    SDL_Texture* coinIcon = Asset_Manager::GetInstance().GetTexture("Coin");
+    SDL_Texture* coinIcon = Asset_Manager::GetInstance().GetTexture(m_coinTexture);
     if (coinIcon)
     {
-        SDL_Rect srcRect = { m_uiCoinCurrentFrame * m_uiCoinFrameWidth, 0, m_uiCoinFrameWidth, m_uiCoinFrameHeight };
+        // Phase 0, so it spins in step with the clock rather than with any one coin
+        const Animation_Clip& clip = Get_Clip(Clip_Id::COIN_SPIN);
+        SDL_Rect srcRect = clip.Source_Rect(coinIcon, Animation_Clock::GetInstance().Frame(clip, 0.0f));
 
         SDL_Rect destRect = { SCREEN_WIDTH - 150, 20, 32, 32 };
 
@@ -496,30 +972,62 @@ void Game::Render_UI()
         if (m_current_State == STATE::PLAYING)
             render_text(renderer, font_regular, "x " + to_string(current_coins), SCREEN_WIDTH - 110, 25);
         else
-            render_text(renderer, font_regular, "x " + to_string(m_totalCoins), SCREEN_WIDTH - 110, 25);
+            render_text(renderer, font_regular, "x " + to_string(m_totalCoins + (m_runUnrecorded ? current_coins : 0)), SCREEN_WIDTH - 110, 25);
     }
 
 }
 
 void Game::Reset_Game()
 {
+    ER_TRACE_SCOPE("Reset_Game");
+    Uint64 resetStart = SDL_GetPerformanceCounter();
+
     m_score = 0;
+    m_runSeconds = 0.0f;
+    m_deathCause = Death_Cause::UNKNOWN;
     m_Player->SetIsDead(false);
+    m_telemetry.Begin_Run();
 
+    // Before anything picks an animation phase
+    Animation_Clock::GetInstance().Set(0.0);
     m_Player->Reset();
+    m_particles.Clear();
+    m_input.Clear();
 
-    m_Obstacles.clear();
-    m_Ground_Segments.clear();
-    m_coins.clear();
-    m_powerUps.clear();
+    // Park everything instead of destroying bodies, the next spawns reuse them
+    Release_Entities();
+    m_stressCursorX = 0.0f;
 
-    current_coins = 0;
+    // Slide the existing ground back under the start position
+    float currentX = 0.0f;
+    for (const auto& segment : m_Ground_Segments)
+    {
+        segment->Respawn(currentX, m_groundTexture);
+        currentX = segment->Get_Right_EdgeX();
+    }
+    while (m_Ground_Segments.size() < 3)
+    {
+        currentX = Spawn_Ground(currentX, m_groundTexture)->Get_Right_EdgeX();
+    }
 
-    Generate_Initial_Ground();
+    current_coins = 0;
     cameraX = 0.0f;
 
     m_Obstacle_Spawn_Timer = 3.0f;
     m_tutorialTextTimer = 5.0f;
+
+    // Every run gets its own seed so it can be told apart (and replayed) later
+    m_runCount++;
+    m_runSeed = static_cast<unsigned int>(time(0)) ^ (m_runCount * 2654435761u);
+    srand(m_runSeed);
+
+    m_rewind.Clear();
+    m_frameIndex = 0;
+
+    for (float& offset : m_starLayerOffsets) offset = 0.0f;
+
+    // Reported with the run's telemetry
+    m_lastResetMs = (SDL_GetPerformanceCounter() - resetStart) * 1000.0 / SDL_GetPerformanceFrequency();
 }
 
 void Game::Render_Playing()
@@ -551,43 +1059,76 @@ void Game::Render_Playing()
 
     m_Player->Render(renderer, cameraX);
 
+    m_particles.Render(renderer, cameraX);
+
     Render_UI();
 }
 
 void Game::Update_Playing(float timeStep)
 {
+    m_runSeconds += timeStep;
+
     // Update Game Objects
     m_Player->Update(World_Id, timeStep, m_score);
 
+    // After the player's update, so a press that arrived just before landing gets the refilled jumps
+    if (m_Player->Can_Jump() && m_input.Take_Jump())
+    {
+        m_Player->Jump();
+    }
+
     Update_Ground();
     Update_Spawning(timeStep);
+    if (m_stress.Active()) Update_Stress();
     Update_Score();
 
-    for (const auto& powerUp : m_powerUps)
+    // Power-ups and coins have no per-frame work: their spin comes off this clock at draw time
+    if (m_tutorialTextTimer > 0) m_tutorialTextTimer -= timeStep;
+    Animation_Clock::GetInstance().Advance(timeStep);
+
+    // Step the Physics World
     {
-        powerUp->Update(World_Id, timeStep, m_score);
+        ER_PROFILE_SCOPE(PHYSICS);
+        b2World_Step(World_Id, timeStep, 3);
     }
 
-    for (const auto& Coin : m_coins)
+    Update_Collisions();
+    m_particles.Update(timeStep);
+
+    // Check for State Change
+    if (m_Player->IsDead())
     {
-        Coin->Update(World_Id, timeStep, m_score);
+        Raise_Event(Game_Event::CRASH, m_Player->get_position());
+
+        // Recorded by Finish_Run once the player leaves game over, unless they retry from a checkpoint
+        m_runUnrecorded = true;
+        Refresh_Game_Over_UI();
+        m_current_State = STATE::GAME_OVER;
     }
 
-    if (m_tutorialTextTimer > 0) m_tutorialTextTimer -= timeStep;
+    // Update the Camera
+    b2Vec2 playerPosMeters = m_Player->get_position();
+    float playerPosPixelsX = playerPosMeters.x * PIXELS_PER_METER;
+    cameraX = playerPosPixelsX - (SCREEN_WIDTH / 2.0f);
+
+    Rebase_Origin();
 
-    m_uiCoinAnimTimer += timeStep;
-    if (m_uiCoinAnimTimer >= m_uiCoinAnimSpeed)
+    // Record this frame for rewinding
+    if (m_current_State == STATE::PLAYING)
     {
-        m_uiCoinCurrentFrame = (m_uiCoinCurrentFrame + 1) % m_uiCoinFrameCount;
-        m_uiCoinAnimTimer -= m_uiCoinAnimSpeed;
+        Capture_Snapshot(m_snapshotScratch);
+        m_rewind.Push(m_frameIndex++, m_snapshotScratch);
     }
 
-    // Step the Physics World
-    b2World_Step(World_Id, timeStep, 3);
+    m_input.Tick(timeStep);
+}
 
+void Game::Update_Collisions()
+{
     // Check for Collisions
     if (!m_Player->IsDead())
     {
+        ER_PROFILE_SCOPE(COLLISIONS);
         b2Vec2 playerCenter = m_Player->get_position();
         float playerRadius = m_Player->Get_Radius_Meters();
 
@@ -611,7 +1152,11 @@ void Game::Update_Playing(float timeStep)
             // Compare that distance to the player's radius squared
             if (distanceSq < (effectiveRadius * effectiveRadius))
             {
+                // Stress runs keep going through hits, they still pay for the test
+                if (m_stress.Active()) continue;
+
                 m_Player->SetIsDead(true);
+                m_deathCause = static_cast<Death_Cause>(static_cast<uint8_t>(obstacle->Get_Kind()) + 1);
                 break;
             }
         }
@@ -620,6 +1165,7 @@ void Game::Update_Playing(float timeStep)
     // Power-up Collision Check
     if (!m_Player->IsDead())
     {
+        ER_PROFILE_SCOPE(COLLISIONS);
         b2Vec2 playerCenter = m_Player->get_position();
         float playerRadius = m_Player->Get_Radius_Meters();
 
@@ -634,9 +1180,10 @@ void Game::Update_Playing(float timeStep)
 
             if (distanceSq < (playerRadius + powerUpRadius) * (playerRadius + powerUpRadius))
             {
-                Audio_Manager::GetInstance().PlaySound("collect_PowerUp");
+                Raise_Event(Game_Event::POWER_UP, powerUpCenter);
                 // Collision! Activate the power-up and remove it.
                 m_Player->ActivatePowerUp(powerUp->GetType());
+                Release_To_Pool(*it, m_powerUpPool);
                 it = m_powerUps.erase(it); // Erase and get next valid iterator
             }
             else
@@ -649,6 +1196,7 @@ void Game::Update_Playing(float timeStep)
     // Coin Collecting
     if (!m_Player->IsDead())
     {
+        ER_PROFILE_SCOPE(COLLISIONS);
         b2Vec2 playerCenter = m_Player->get_position();
         float playerRadius = m_Player->Get_Radius_Meters();
 
@@ -663,8 +1211,9 @@ void Game::Update_Playing(float timeStep)
 
             if (distanceSq < (playerRadius + coinUpRadius) * (playerRadius + coinUpRadius))
             {
-                Audio_Manager::GetInstance().PlaySound("collect_Coin");
+                Raise_Event(Game_Event::COIN_PICKUP, powerUpCenter);
                 current_coins++;
+                Release_To_Pool(*it, m_coinPool);
                 it = m_coins.erase(it); // Erase and get next valid iterator
             }
             else
@@ -673,21 +1222,61 @@ void Game::Update_Playing(float timeStep)
             }
         }
     }
+}
 
-    // Check for State Change
-    if (m_Player->IsDead())
+void Game::Raise_Event(Game_Event event, b2Vec2 positionMeters)
+{
+    const float PI = 3.14159265f;
+    float x = positionMeters.x * PIXELS_PER_METER;
+    float y = positionMeters.y * PIXELS_PER_METER;
+
+    // count, speed, angle and spread, life, size, gravity, color
+    switch (event)
     {
-        Audio_Manager::GetInstance().PlaySound("crash");
-        Update_High_Scores();
-        m_totalCoins += current_coins;
-        SaveWallet();
-        m_current_State = STATE::GAME_OVER;
+        case Game_Event::COIN_PICKUP:
+            Audio_Manager::GetInstance().PlaySound(m_coinSound);
+            m_particles.Emit(m_sparkPool, x, y, { 24, 60.0f, 180.0f, -PI / 2.0f, PI, 0.3f, 0.6f, 3.0f, 6.0f, 300.0f, { 255, 210, 60, 255 } });
+            break;
+        case Game_Event::POWER_UP:
+            Audio_Manager::GetInstance().PlaySound(m_powerUpSound);
+            m_particles.Emit(m_sparkPool, x, y, { 60, 100.0f, 260.0f, 0.0f, PI, 0.4f, 0.8f, 4.0f, 8.0f, 0.0f, { 80, 220, 255, 255 } });
+            break;
+        case Game_Event::CRASH:
+            Audio_Manager::GetInstance().PlaySound(m_crashSound);
+            m_particles.Emit(m_sparkPool, x, y, { 400, 150.0f, 500.0f, -PI / 2.0f, PI * 0.6f, 0.6f, 1.4f, 3.0f, 9.0f, 900.0f, { 255, 140, 40, 255 } });
+            m_particles.Emit(m_sparkPool, x, y, { 150, 20.0f, 90.0f, -PI / 2.0f, PI, 1.0f, 2.0f, 8.0f, 16.0f, -40.0f, { 90, 90, 100, 160 } });
+            break;
     }
+}
 
-    // Update the Camera
-    b2Vec2 playerPosMeters = m_Player->get_position();
-    float playerPosPixelsX = playerPosMeters.x * PIXELS_PER_METER;
-    cameraX = playerPosPixelsX - (SCREEN_WIDTH / 2.0f);
+void Game::Rebase_Origin()
+{
+    ER_TRACE_SCOPE("Rebase_Origin");
+    float playerX = m_Player->get_position().x;
+    if (playerX < REBASE_THRESHOLD_METERS) return;
+
+    // Shift by whole meters so every position keeps the same fractional part in pixels
+    const float startX = 300.0f / PIXELS_PER_METER;
+    b2Vec2 shift = { floorf(playerX - startX), 0.0f };
+    float shiftPx = shift.x * PIXELS_PER_METER;
+
+    m_Player->Shift_Origin(shift);
+    for (const auto& segment : m_Ground_Segments) segment->Shift_Origin(shift);
+    for (const auto& obstacle : m_Obstacles) obstacle->Shift_Origin(shift);
+    for (const auto& powerUp : m_powerUps) powerUp->Shift_Origin(shift);
+    for (const auto& coin : m_coins) coin->Shift_Origin(shift);
+    m_particles.Shift_Origin(shiftPx);
+    // Pooled objects are re-placed when they respawn, so they don't need shifting
+
+    cameraX -= shiftPx;
+    m_stressCursorX -= shiftPx;
+
+    // Carry the parallax scroll the camera just lost over into each star layer
+    const float wrapWidth = SCREEN_WIDTH * 2.0f;
+    for (int i = 0; i < 3; ++i)
+    {
+        m_starLayerOffsets[i] = fmodf(m_starLayerOffsets[i] + shiftPx * STAR_LAYER_SPEEDS[i], wrapWidth);
+    }
 }
 
 void Game::Render_GameOver()
@@ -696,72 +1285,25 @@ void Game::Render_GameOver()
     Render_Playing();
 
     // Then, draw the game over UI on top
-    render_text(renderer, font_large, "Game Over", SCREEN_WIDTH / 2 - 120, 200);
-
-    string scoreText = "Final Score: " + to_string(m_score);
-    render_text(renderer, font_regular, scoreText, SCREEN_WIDTH / 2 - 75, 320);
-
-    // Draw buttons
-    render_text(renderer, font_regular, "Restart", SCREEN_WIDTH / 2 - 45, 400);
-    render_text(renderer, font_regular, "Main Menu", SCREEN_WIDTH / 2 - 65, 460);
+    m_gameOverUI.tree.Render(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void Game::Render_MainMenu()
 {
     Render_Playing();
 
-    // --- Draw Title ---
-    render_text(renderer, font_large, "Endless Runner", SCREEN_WIDTH / 2 - 150, 100);
-
-    // --- Draw Buttons ---
-    SDL_Rect startButtonRect = { SCREEN_WIDTH / 2 - 95, 360, 200, 50 };
-    SDL_Rect shopButtonRect = { SCREEN_WIDTH / 2 - 95, 420, 200, 50 };
-    SDL_Rect quitButtonRect = { SCREEN_WIDTH / 2 - 95, 480, 200, 50 };
-
-    // Draw button backgrounds
-    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
-    SDL_RenderDrawRect(renderer, &startButtonRect);
-    SDL_RenderDrawRect(renderer, &shopButtonRect);
-    SDL_RenderDrawRect(renderer, &quitButtonRect);
-
-    // Draw button text
-    render_text(renderer, font_regular, "Start", SCREEN_WIDTH / 2 - 25, 370);
-    render_text(renderer, font_regular, "Shop", SCREEN_WIDTH / 2 - 25, 430);
-    render_text(renderer, font_regular, "Quit", SCREEN_WIDTH / 2 - 20, 490);
-
-    // --- Draw High Scores Box ---
-    render_text(renderer, font_regular, "High Scores", 100, 250);
-
-    int yPos = 300;
-    for (size_t i = 0; i < m_high_Scores.size() && i < 5; ++i)
-    {
-        SDL_Texture* medalTexture = nullptr;
-        if (i == 0) medalTexture = Asset_Manager::GetInstance().GetTexture("medal_gold");
-        else if (i == 1) medalTexture = Asset_Manager::GetInstance().GetTexture("medal_silver");
-        else if (i == 2) medalTexture = Asset_Manager::GetInstance().GetTexture("medal_bronze");
-
-        if (medalTexture)
-        {
-            SDL_Rect medalRect = { 100, yPos, 32, 55 }; // Position just left of the text
-            SDL_RenderCopy(renderer, medalTexture, NULL, &medalRect);
-        }
-
-        string scoreText = to_string(i + 1) + ". " + to_string(m_high_Scores[i]);
-        render_text(renderer, font_regular, scoreText, 140, yPos);
-        yPos += 60;
-    }
+    m_menuUI.tree.Render(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void Game::HandleEvents_Playing(const SDL_Event& event)
 {
-    if (event.type == SDL_KEYDOWN)
+    // Key repeat isn't a new press, so holding space can't sit in the buffer
+    if (event.type == SDL_KEYDOWN && !event.key.repeat)
     {
         if (event.key.keysym.sym == SDLK_SPACE)
         {
-            if (m_Player->Can_Jump())
-            {
-                m_Player->Jump();
-            }
+            // Applied by this frame's tick if the player can jump, otherwise held for the jump buffer
+            m_input.Press(event.key.timestamp, 1.0f / TARGET_FPS);
         }
     }
 }
@@ -770,32 +1312,25 @@ void Game::HandleEvents_MainMenu(const SDL_Event& event)
 {
     if (event.type == SDL_MOUSEBUTTONDOWN)
     {
-        int mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
-        SDL_Point mousePoint = { mouseX, mouseY };
-
-        SDL_Rect startButtonRect = { SCREEN_WIDTH / 2 - 95, 360, 200, 50 };
-        SDL_Rect shopButtonRect = { SCREEN_WIDTH / 2 - 95, 420, 200, 50 };
-        SDL_Rect quitButtonRect = { SCREEN_WIDTH / 2 - 95, 480, 200, 50 };
+        int hit = m_menuUI.tree.Hit_Test(event.button.x, event.button.y);
+        if (hit < 0) return;
 
-        if (SDL_PointInRect(&mousePoint, &startButtonRect))
+        Audio_Manager::GetInstance().PlaySound(m_clickSound);
+        if (hit == m_menuUI.start)
         {
-            Audio_Manager::GetInstance().PlaySound("UI_click");
             Reset_Game();
             m_current_State = STATE::PLAYING;
         }
-        else if (SDL_PointInRect(&mousePoint, &quitButtonRect))
+        else if (hit == m_menuUI.quit)
         {
-            Audio_Manager::GetInstance().PlaySound("UI_click");
             running = false;
             Audio_Manager::GetInstance().CleanUp();
         }
-        else if (SDL_PointInRect(&mousePoint, &shopButtonRect))
+        else if (hit == m_menuUI.shop)
         {
-            Audio_Manager::GetInstance().PlaySound("UI_click");
+            Refresh_Shop_UI();
             m_current_State = STATE::SHOP;
         }
-
     }
 }
 
@@ -803,70 +1338,106 @@ void Game::HandleEvents_GameOver(const SDL_Event& event)
 {
     if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT)
     {
-        int mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
-        SDL_Point mousePoint = { mouseX, mouseY };
-
-        int restartTextW, restartTextH;
-        TTF_SizeText(font_regular, "Restart", &restartTextW, &restartTextH);
-        SDL_Rect restartButtonRect = {
-                SCREEN_WIDTH / 2 - restartTextW / 2,
-                400,
-                restartTextW,
-                restartTextH
-        };
-
-        int menuTextW, menuTextH;
-        TTF_SizeText(font_regular, "Main Menu", &menuTextW, &menuTextH);
-        SDL_Rect menuButtonRect = {
-                SCREEN_WIDTH / 2 - menuTextW / 2,
-                460,
-                menuTextW,
-                menuTextH
-        };
-
-        if (SDL_PointInRect(&mousePoint, &restartButtonRect))
+        int hit = m_gameOverUI.tree.Hit_Test(event.button.x, event.button.y);
+        if (hit < 0) return;
+
+        Audio_Manager::GetInstance().PlaySound(m_clickSound);
+        if (hit == m_gameOverUI.restart)
         {
-            Audio_Manager::GetInstance().PlaySound("UI_click");
+            Finish_Run();
             Reset_Game();
             m_current_State = STATE::PLAYING;
         }
-        else if (SDL_PointInRect(&mousePoint, &menuButtonRect))
+        else if (hit == m_gameOverUI.menu)
         {
-            Audio_Manager::GetInstance().PlaySound("UI_click");
+            Finish_Run();
             m_current_State = STATE::MAIN_MENU;
         }
+        else if (hit == m_gameOverUI.checkpoint)
+        {
+            Retry_From_Checkpoint();
+        }
     }
 }
 
 // Saving
 
-void Game::Save_Scores()
+void Game::Record_Run()
+{
+    ER_TRACE_SCOPE("Record_Run");
+    Run_Record record;
+    record.score = static_cast<int32_t>(m_score);
+    record.coins = static_cast<int32_t>(current_coins);
+    record.durationSeconds = m_runSeconds;
+    record.deathCause = m_deathCause;
+    record.seed = m_runSeed;
+    record.day = Run_History::Today();
+    m_history.Append(record);
+
+    m_telemetry.End_Run({ m_score, current_coins, m_runSeconds, m_runSeed, Death_Cause_Name(m_deathCause), m_lastResetMs });
+
+    m_panelScores = m_history.Top(5);
+    Refresh_Score_Panel();
+}
+
+void Game::Finish_Run()
 {
-    ofstream scoreFile("scores.txt");
-    if (scoreFile.is_open())
+    if (!m_runUnrecorded) return;
+    m_runUnrecorded = false;
+
+    Update_High_Scores();
+    Record_Run();
+    m_totalCoins += current_coins;
+    Save_Profile();
+}
+
+void Game::Save_Profile()
+{
+    ER_TRACE_SCOPE("Save_Profile");
+    Profile profile;
+    profile.highScores = m_high_Scores;
+    profile.totalCoins = m_totalCoins;
+    profile.equippedSkin = m_equippedSkinId;
+    for (const Skin& skin : m_allSkins)
     {
-        for (int score : m_high_Scores)
-        {
-            scoreFile << score << endl;
-        }
-        scoreFile.close();
+        if (skin.isUnlocked) profile.unlockedSkins.push_back(skin.id);
     }
+
+    // Encoding is a few hundred bytes; the file I/O happens on the writer thread
+    vector<uint8_t> data;
+    Profile_Store::Encode(profile, data);
+    m_profileWriter.Write(m_profilePath, std::move(data));
 }
 
-void Game::Load_Scores()
+void Game::Load_Profile()
 {
-    ifstream scoreFile("scores.txt");
-    if (scoreFile.is_open())
+    Profile profile;
+    if (!Profile_Store::Load(m_profilePath, profile))
     {
-        m_high_Scores.clear();
-        string line;
-        while (getline(scoreFile, line))
+        if (filesystem::exists(m_profilePath))
         {
-            m_high_Scores.push_back(stoi(line));
+            cerr << "Profile " << m_profilePath << " is damaged or from a newer version, not loading it" << endl;
+            return;
         }
-        scoreFile.close();
+
+        // First launch since the text files were replaced, carry them over
+        if (!Profile_Store::Import_Legacy("scores.txt", "wallet.txt", profile)) return;
+        cout << "Imported scores.txt and wallet.txt into " << m_profilePath << endl;
     }
+
+    m_high_Scores = profile.highScores;
+    sort(m_high_Scores.begin(), m_high_Scores.end(), greater<int>());
+    m_totalCoins = profile.totalCoins;
+    m_equippedSkinId = profile.equippedSkin;
+    for (Skin& skin : m_allSkins)
+    {
+        if (find(profile.unlockedSkins.begin(), profile.unlockedSkins.end(), skin.id) != profile.unlockedSkins.end())
+        {
+            skin.isUnlocked = true;
+        }
+    }
+
+    if (!filesystem::exists(m_profilePath)) Save_Profile();
 }
 
 void Game::Update_High_Scores()
@@ -879,74 +1450,95 @@ void Game::Update_High_Scores()
     {
         m_high_Scores.resize(5);
     }
-
-    Save_Scores();
 }
 
-void Game::SaveWallet()
-{
-    std::ofstream walletFile("wallet.txt");
-    if (walletFile.is_open())
-    {
-        walletFile << m_totalCoins; // Write the single integer
-        walletFile.close();
-    }
-}
+// Textures
 
-void Game::LoadWallet()
+void Game::Resolve_Handles()
 {
-    std::ifstream walletFile("wallet.txt");
-    if (walletFile.is_open())
+    Asset_Manager& assets = Asset_Manager::GetInstance();
+    m_coinTexture = assets.GetHandle("Coin");
+    m_groundTexture = assets.GetHandle("Ground_Sand");
+    m_medalTextures[0] = assets.GetHandle("medal_gold");
+    m_medalTextures[1] = assets.GetHandle("medal_silver");
+    m_medalTextures[2] = assets.GetHandle("medal_bronze");
+
+    for (Skin& skin : m_allSkins)
     {
-        walletFile >> m_totalCoins; // Read the single integer
-        walletFile.close();
+        skin.texture = assets.GetHandle(skin.id);
     }
-}
 
-// Textures
+    Audio_Manager& audio = Audio_Manager::GetInstance();
+    m_clickSound = audio.GetHandle("UI_click");
+    m_coinSound = audio.GetHandle("collect_Coin");
+    m_powerUpSound = audio.GetHandle("collect_PowerUp");
+    m_crashSound = audio.GetHandle("crash");
+
+    // Crash always gets heard, coins give way first
+    audio.SetVoiceRule(m_crashSound, 3, 1);
+    audio.SetVoiceRule(m_powerUpSound, 2, 1);
+    audio.SetVoiceRule(m_clickSound, 2, 1);
+    audio.SetVoiceRule(audio.GetHandle("jump"), 1, 2);
+    audio.SetVoiceRule(m_coinSound, 0, 3);
+}
 
 void Game::Load_Assets()
 {
-    // Player
-    Asset_Manager::GetInstance().LoadTexture("player_default", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienGreen.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("player_skin1", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienBeige.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("player_skin2", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienBlue.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("player_skin3", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienPink.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("player_skin4", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienYellow.png", renderer);
+    Asset_Manager& assets = Asset_Manager::GetInstance();
+
+    // Player. Only the default sheet is needed to play, the other skins load when the shop shows them.
+    m_loader.Queue_Texture("player_default", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienGreen.png");
+    assets.Register("player_skin1", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienBeige.png");
+    assets.Register("player_skin2", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienBlue.png");
+    assets.Register("player_skin3", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienPink.png");
+    assets.Register("player_skin4", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Spritesheets//alienYellow.png");
 
     // Small Obstacles
-    Asset_Manager::GetInstance().LoadTexture("obstacle_small_GreenMonster_Angry", "D://Textures//kenney_platformer-art-deluxe//Base pack//Enemies//blockerMad.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("obstacle_small_Creature", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Enemy sprites//barnacle.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("obstacle_small_GreenMonster_Poker","D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Enemy sprites//slimeBlock.png", renderer);
-    small_obstacle_skins = { "obstacle_small_GreenMonster_Angry", "obstacle_small_Creature", "obstacle_small_GreenMonster_Poker" };
+    m_loader.Queue_Texture("obstacle_small_GreenMonster_Angry", "D://Textures//kenney_platformer-art-deluxe//Base pack//Enemies//blockerMad.png");
+    m_loader.Queue_Texture("obstacle_small_Creature", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Enemy sprites//barnacle.png");
+    m_loader.Queue_Texture("obstacle_small_GreenMonster_Poker","D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Enemy sprites//slimeBlock.png");
+    small_obstacle_skins = Resolve_Textures({ "obstacle_small_GreenMonster_Angry", "obstacle_small_Creature", "obstacle_small_GreenMonster_Poker" });
 
     // Tall Obstacles
-    Asset_Manager::GetInstance().LoadTexture("obstacle_tall_OrangeMonster_Sad", "D://Textures//kenney_platformer-art-deluxe//Base pack//Enemies//pokerSad.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("obstacle_tall_GreenMonster_Poker", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Enemy sprites//snakeSlime.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("obstacle_tall_OrangeMonster_Angry", "D://Textures//kenney_platformer-art-deluxe//Base pack//Enemies//pokerMad.png", renderer);
-    tall_obstacle_skins = { "obstacle_tall_OrangeMonster_Sad", "obstacle_tall_GreenMonster_Poker", "obstacle_tall_OrangeMonster_Angry" };
+    m_loader.Queue_Texture("obstacle_tall_OrangeMonster_Sad", "D://Textures//kenney_platformer-art-deluxe//Base pack//Enemies//pokerSad.png");
+    m_loader.Queue_Texture("obstacle_tall_GreenMonster_Poker", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Enemy sprites//snakeSlime.png");
+    m_loader.Queue_Texture("obstacle_tall_OrangeMonster_Angry", "D://Textures//kenney_platformer-art-deluxe//Base pack//Enemies//pokerMad.png");
+    tall_obstacle_skins = Resolve_Textures({ "obstacle_tall_OrangeMonster_Sad", "obstacle_tall_GreenMonster_Poker", "obstacle_tall_OrangeMonster_Angry" });
 
     // Wide Obstacles
-    Asset_Manager::GetInstance().LoadTexture("obstacle_wide", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Enemy sprites//worm.png", renderer);
-    wide_obstacle_skins = { "obstacle_wide" };
+    m_loader.Queue_Texture("obstacle_wide", "D://Textures//kenney_platformer-art-deluxe//Extra animations and enemies//Enemy sprites//worm.png");
+    wide_obstacle_skins = Resolve_Textures({ "obstacle_wide" });
 
     // Power Ups
-    Asset_Manager::GetInstance().LoadTexture("powerUp", "D://Textures//Game asset - Shining items sprite sheets v2//spritesheet _powerUp.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("health", "D://Textures//Game asset - Shining items sprite sheets v2//spritesheet_health.png", renderer);
+    m_loader.Queue_Texture("powerUp", "D://Textures//Game asset - Shining items sprite sheets v2//spritesheet _powerUp.png");
+    m_loader.Queue_Texture("health", "D://Textures//Game asset - Shining items sprite sheets v2//spritesheet_health.png");
 
     // Coins
-    Asset_Manager::GetInstance().LoadTexture("Coin", "D://Textures//Game asset - Shining items sprite sheets v2//spritesheet_Coin.png", renderer);
+    m_loader.Queue_Texture("Coin", "D://Textures//Game asset - Shining items sprite sheets v2//spritesheet_Coin.png");
 
     // Ground
-    Asset_Manager::GetInstance().LoadTexture("Ground_Sand", "D://Textures//kenney_platformer-art-deluxe//Base pack//Tiles//sandCenter.png", renderer);
+    m_loader.Queue_Texture("Ground_Sand", "D://Textures//kenney_platformer-art-deluxe//Base pack//Tiles//sandCenter.png");
 
-    // Medals
-    Asset_Manager::GetInstance().LoadTexture("medal_gold", "D://Textures//kenneymedals//PNG//flat_medal8.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("medal_silver", "D://Textures//kenneymedals//PNG//flatshadow_medal3.png", renderer);
-    Asset_Manager::GetInstance().LoadTexture("medal_bronze", "D://Textures//kenneymedals//PNG//flatshadow_medal2.png", renderer);
+    // Medals, menu only
+    assets.Register("medal_gold", "D://Textures//kenneymedals//PNG//flat_medal8.png");
+    assets.Register("medal_silver", "D://Textures//kenneymedals//PNG//flatshadow_medal3.png");
+    assets.Register("medal_bronze", "D://Textures//kenneymedals//PNG//flatshadow_medal2.png");
 
 
 //    Asset_Manager::GetInstance().LoadTexture("obstacle_rock", "D:\Textures\Game asset - Shining items sprite sheets v2\spritesheet_health.png", renderer);
+
+    // Sounds
+    m_loader.Queue_Sound("jump", "D://SOUND_EFFECTS//qubodup-cfork-ccby3-jump.ogg");
+    m_loader.Queue_Sound("crash", "D://SOUND_EFFECTS//zoom3.wav");
+    m_loader.Queue_Sound("UI_click", "D://SOUND_EFFECTS//UI//switch9.ogg");
+    m_loader.Queue_Sound("collect_Coin", "D://SOUND_EFFECTS//retro-game-coin-pickup-jam-fx-1-00-03.mp3");
+    m_loader.Queue_Sound("collect_PowerUp", "D://SOUND_EFFECTS//video-game-bonus-retro-sparkle-gamemaster-audio-lower-tone-1-00-00.mp3");
+
+    // SDL_image loads its codecs lazily, do it here so the workers don't race on it
+    IMG_Init(IMG_INIT_PNG);
+
+    int hardwareThreads = static_cast<int>(thread::hardware_concurrency());
+    m_loader.Start(Config_Int("ER_LOADER_THREADS", max(1, hardwareThreads - 1)));
 }
 
 // BackGround
@@ -972,33 +1564,34 @@ void Game::GenerateStars()
 
 void Game::RenderStarfield()
 {
-    const float LAYER_SPEEDS[] = {0.15f, 0.25f, 0.50f};
-
     const SDL_Color LAYER_COLORS[] = {
             {100, 100, 100, 255}, // Far stars
             {170, 170, 170, 255}, // Middle stars
             {255, 255, 255, 255}  // Near stars
     };
 
+    const int wrapWidth = SCREEN_WIDTH * 2;
+
     for (int i = 0; i < m_starLayers.size(); ++i)
     {
         SDL_SetRenderDrawColor(renderer, LAYER_COLORS[i].r, LAYER_COLORS[i].g, LAYER_COLORS[i].b, LAYER_COLORS[i].a);
 
-        // Calculate how much this layer should scroll based on the camera
-        int parallaxX = static_cast<int>(cameraX * LAYER_SPEEDS[i]);
+        // Calculate how much this layer should scroll based on the camera,
+        // wrapped once here so the cost doesn't grow with the distance travelled
+        float scroll = fmodf(cameraX * STAR_LAYER_SPEEDS[i] + m_starLayerOffsets[i], static_cast<float>(wrapWidth));
+        if (scroll < 0.0f) scroll += wrapWidth;
+        int parallaxX = static_cast<int>(scroll);
 
         for (const auto& star : m_starLayers[i])
         {
             int screenX = star.x - parallaxX;
             int screenY = star.y;
 
-            // If the star scrolls off the left, wrap it to the right
-            while (screenX < 0)
+            // Stars live in [0, wrapWidth) so one step wraps them back on
+            if (screenX < 0)
             {
-                screenX += SCREEN_WIDTH * 2;
+                screenX += wrapWidth;
             }
-            // Use modulo to keep the star within two screen widths
-            screenX %= (SCREEN_WIDTH * 2);
 
             SDL_RenderDrawPoint(renderer, screenX, screenY);
         }
@@ -1024,6 +1617,7 @@ void Game::HandleEvents_Shop(const SDL_Event& event)
                 m_currentSkinIndex = m_allSkins.size() - 1;
             }
         }
+        Refresh_Shop_UI();
     }
     // Add logic for a "Back" button click that returns to the Main Menu
 }
@@ -1039,43 +1633,131 @@ void Game::Render_Shop()
     SDL_SetRenderDrawColor(renderer, 30, 30, 50, 255); // Dark blue background
     SDL_RenderClear(renderer);
 
-    // --- Calculate Indices for Wrapping ---
-    int prevIndex = (m_currentSkinIndex - 1 + m_allSkins.size()) % m_allSkins.size();
-    int nextIndex = (m_currentSkinIndex + 1) % m_allSkins.size();
+    m_shopUI.tree.Render(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+void Game::InitializeSkins()
+{
+    // Define all the skins available in your game
+    m_allSkins.push_back({"player_default", "Default Alien", 0, true}); // The first skin is free and unlocked
+    m_allSkins.push_back({"player_green", "Green Alien", 100, false});
+    m_allSkins.push_back({"player_pink", "Pink Alien", 150, false});
+    // Add more skins here
+}
 
-    Skin& currentSkin = m_allSkins[m_currentSkinIndex];
-    Skin& prevSkin = m_allSkins[prevIndex];
-    Skin& nextSkin = m_allSkins[nextIndex];
+// Menus
 
-    // --- Get Textures from AssetManager ---
-    SDL_Texture* currentTex = Asset_Manager::GetInstance().GetTexture(currentSkin.id);
-    SDL_Texture* prevTex = Asset_Manager::GetInstance().GetTexture(prevSkin.id);
-    SDL_Texture* nextTex = Asset_Manager::GetInstance().GetTexture(nextSkin.id);
+void Game::Build_UI()
+{
+    // --- Main Menu ---
+    UI_Tree& menu = m_menuUI.tree;
+    menu.Add_Label(-1, font_large, "Endless Runner", UI_Align::CENTER, 0, 100);
+
+    m_menuUI.start = menu.Add_Button(-1, font_regular, "Start", UI_Align::CENTER, 5, 360, 200, 50);
+    m_menuUI.shop = menu.Add_Button(-1, font_regular, "Shop", UI_Align::CENTER, 5, 420, 200, 50);
+    m_menuUI.quit = menu.Add_Button(-1, font_regular, "Quit", UI_Align::CENTER, 5, 480, 200, 50);
+    for (int button : { m_menuUI.start, m_menuUI.shop, m_menuUI.quit })
+    {
+        menu.Set_Colors(button, { 0, 0, 0, 0 }, { 100, 100, 100, 255 });
+    }
 
-    // --- Draw the Skins ---
-    // Draw current skin large and in the center
-    SDL_Rect currentRect = { SCREEN_WIDTH / 2 - 75, 200, 150, 150 };
-    if (currentTex) SDL_RenderCopy(renderer, currentTex, NULL, &currentRect);
+    // High scores, with medals just left of the top three
+    int scoresPanel = menu.Add_Panel(-1, UI_Align::LEFT, 100, 250, 300, 350);
+    menu.Add_Label(scoresPanel, font_regular, "High Scores", UI_Align::LEFT, 0, 0);
+    for (int i = 0; i < 5; ++i)
+    {
+        int y = 50 + i * 60;
+        if (i < 3) m_menuUI.medals[i] = menu.Add_Image(scoresPanel, m_medalTextures[i], UI_Align::LEFT, 0, y, 32, 55);
+        m_menuUI.scores[i] = menu.Add_Label(scoresPanel, font_regular, "", UI_Align::LEFT, 40, y);
+    }
+    Refresh_Score_Panel();
+
+    // --- Game Over ---
+    UI_Tree& gameOver = m_gameOverUI.tree;
+    gameOver.Add_Label(-1, font_large, "Game Over", UI_Align::CENTER, 0, 200);
+    m_gameOverUI.score = gameOver.Add_Label(-1, font_regular, "", UI_Align::CENTER, 0, 320);
+    m_gameOverUI.stats = gameOver.Add_Label(-1, font_regular, "", UI_Align::CENTER, 0, 355);
+    m_gameOverUI.restart = gameOver.Add_Button(-1, font_regular, "Restart", UI_Align::CENTER, 0, 400);
+    m_gameOverUI.menu = gameOver.Add_Button(-1, font_regular, "Main Menu", UI_Align::CENTER, 0, 460);
+    m_gameOverUI.checkpoint = gameOver.Add_Button(-1, font_regular, "Retry Checkpoint", UI_Align::CENTER, 0, 520);
+
+    // --- Shop ---
+    // Current skin large and in the center, the previous and next smaller to the sides
+    UI_Tree& shop = m_shopUI.tree;
+    m_shopUI.current = shop.Add_Image(-1, Texture_Handle(), UI_Align::CENTER, 0, 200, 150, 150);
+    m_shopUI.previous = shop.Add_Image(-1, Texture_Handle(), UI_Align::CENTER, -150, 250, 100, 100);
+    m_shopUI.next = shop.Add_Image(-1, Texture_Handle(), UI_Align::CENTER, 150, 250, 100, 100);
+    m_shopUI.name = shop.Add_Label(-1, font_large, "", UI_Align::CENTER, 0, 400);
+    m_shopUI.price = shop.Add_Label(-1, font_regular, "", UI_Align::CENTER, 0, 450);
+    m_shopUI.button = shop.Add_Button(-1, font_regular, "", UI_Align::CENTER, 0, 500, 200, 50);
+    m_shopUI.wallet = shop.Add_Label(-1, font_regular, "", UI_Align::LEFT, 20, 20);
+    Refresh_Shop_UI();
+
+    // So clicks hit the right rects even before a screen's first draw
+    menu.Layout(SCREEN_WIDTH, SCREEN_HEIGHT);
+    gameOver.Layout(SCREEN_WIDTH, SCREEN_HEIGHT);
+    shop.Layout(SCREEN_WIDTH, SCREEN_HEIGHT);
+}
 
-    // Draw previous and next skins smaller and to the sides
-    SDL_Rect prevRect = { SCREEN_WIDTH / 2 - 200, 250, 100, 100 };
-    if (prevTex) SDL_RenderCopy(renderer, prevTex, NULL, &prevRect);
+void Game::Refresh_Score_Panel()
+{
+    // The history only has runs since it was added, the profile's top five can be older. A run kept in
+    // both lists must show once, so it's their sorted multiset union.
+    vector<int> scores;
+    set_union(m_panelScores.begin(), m_panelScores.end(), m_high_Scores.begin(), m_high_Scores.end(),
+              back_inserter(scores), greater<int>());
+    if (scores.size() > 5) scores.resize(5);
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        bool shown = i < scores.size();
+        m_menuUI.tree.Set_Visible(m_menuUI.scores[i], shown);
+        if (i < 3) m_menuUI.tree.Set_Visible(m_menuUI.medals[i], shown);
+        if (shown) m_menuUI.tree.Set_Text(m_menuUI.scores[i], to_string(i + 1) + ". " + to_string(scores[i]));
+    }
+}
 
-    SDL_Rect nextRect = { SCREEN_WIDTH / 2 + 100, 250, 100, 100 };
-    if (nextTex) SDL_RenderCopy(renderer, nextTex, NULL, &nextRect);
+void Game::Refresh_Game_Over_UI()
+{
+    UI_Tree& tree = m_gameOverUI.tree;
+    tree.Set_Text(m_gameOverUI.score, "Final Score: " + to_string(m_score));
 
-    // --- Draw Skin Name and Price ---
-    render_text(renderer, font_large, currentSkin.displayName, SCREEN_WIDTH/2 - 100, 400);
-    if (!currentSkin.isUnlocked) {
-        std::string priceText = std::to_string(currentSkin.price) + " Coins";
-        render_text(renderer, font_regular, priceText, SCREEN_WIDTH/2 - 50, 450);
+    // This run isn't in the history until it's recorded, so it's compared against the earlier ones
+    tree.Set_Visible(m_gameOverUI.stats, m_history.Count() > 0);
+    if (m_history.Count() > 0)
+    {
+        int better = static_cast<int>(m_history.Rank(static_cast<int>(m_score)) * 100.0f);
+        const Day_Summary* today = m_history.Day(Run_History::Today());
+        int runsToday = (today ? today->runs : 0) + 1;
+        int bestToday = max(today ? today->bestScore : 0, static_cast<int>(m_score));
+        string statsText = "Better than " + to_string(better) + "% of your runs";
+        statsText += " | Today: " + to_string(runsToday) + " runs, best " + to_string(bestToday);
+        tree.Set_Text(m_gameOverUI.stats, statsText);
     }
 
-    // --- Draw the Dynamic Button ---
-    SDL_Rect buttonRect = { SCREEN_WIDTH / 2 - 100, 500, 200, 50 };
-    std::string buttonText;
-    SDL_Color buttonColor;
+    tree.Set_Visible(m_gameOverUI.checkpoint, Has_Checkpoint());
+}
+
+void Game::Refresh_Shop_UI()
+{
+    // --- Calculate Indices for Wrapping ---
+    int prevIndex = (m_currentSkinIndex - 1 + m_allSkins.size()) % m_allSkins.size();
+    int nextIndex = (m_currentSkinIndex + 1) % m_allSkins.size();
+    const Skin& currentSkin = m_allSkins[m_currentSkinIndex];
+
+    UI_Tree& tree = m_shopUI.tree;
+    tree.Set_Image(m_shopUI.current, currentSkin.texture);
+    tree.Set_Image(m_shopUI.previous, m_allSkins[prevIndex].texture);
+    tree.Set_Image(m_shopUI.next, m_allSkins[nextIndex].texture);
 
+    // --- Skin Name and Price ---
+    tree.Set_Text(m_shopUI.name, currentSkin.displayName);
+    tree.Set_Visible(m_shopUI.price, !currentSkin.isUnlocked);
+    tree.Set_Text(m_shopUI.price, to_string(currentSkin.price) + " Coins");
+
+    // --- The Dynamic Button ---
+    string buttonText;
+    SDL_Color buttonColor;
     if (currentSkin.id == m_equippedSkinId) {
         buttonText = "Equipped";
         buttonColor = {50, 50, 50, 255}; // Disabled color
@@ -1090,22 +1772,242 @@ void Game::Render_Shop()
             buttonColor = {150, 0, 0, 255}; // Red (not enough coins)
         }
     }
-    SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-    SDL_RenderFillRect(renderer, &buttonRect);
-    render_text(renderer, font_regular, buttonText, SCREEN_WIDTH/2 - 40, 510);
+    tree.Set_Text(m_shopUI.button, buttonText);
+    tree.Set_Colors(m_shopUI.button, buttonColor, { 0, 0, 0, 0 });
+
+    // Player's total coin balance
+    tree.Set_Text(m_shopUI.wallet, "Your Coins: " + to_string(m_totalCoins));
+}
 
-    // Draw player's total coin balance
-    std::string walletText = "Your Coins: " + std::to_string(m_totalCoins);
-    render_text(renderer, font_regular, walletText, 20, 20);
+// Snapshots
 
-    SDL_RenderPresent(renderer);
+namespace
+{
+    const uint32_t SNAPSHOT_MAGIC = 0x45525331; // "ERS1"
+
+    void Write_Player_State(Snapshot_Writer& writer, const Player_State& state)
+    {
+        writer.Write(state.position);
+        writer.Write(state.velocity);
+        writer.Write(static_cast<uint8_t>(state.isDead));
+        writer.Write(static_cast<int32_t>(state.jumpsLeft));
+        writer.Write(state.airSeconds);
+        writer.Write(static_cast<uint8_t>(state.groundJumpUsed));
+        writer.Write(state.doubleScoreTimer);
+        writer.Write(state.extraJumpTimer);
+        writer.Write(state.speed);
+        writer.Write(static_cast<int32_t>(state.animState));
+        writer.Write(state.animPhase);
+    }
+
+    bool Read_Player_State(Snapshot_Reader& reader, Player_State& state)
+    {
+        uint8_t isDead, groundJumpUsed;
+        int32_t jumpsLeft, animState;
+        if (!reader.Read(state.position) || !reader.Read(state.velocity) || !reader.Read(isDead) || !reader.Read(jumpsLeft)
+            || !reader.Read(state.airSeconds) || !reader.Read(groundJumpUsed) || !reader.Read(state.doubleScoreTimer)
+            || !reader.Read(state.extraJumpTimer) || !reader.Read(state.speed) || !reader.Read(animState)
+            || !reader.Read(state.animPhase)) return false;
+
+        state.isDead = isDead != 0;
+        state.jumpsLeft = jumpsLeft;
+        state.groundJumpUsed = groundJumpUsed != 0;
+        state.animState = animState;
+        return true;
+    }
+
+    // A snapshot's entities, parsed in full before the live world is touched
+    struct Ground_Record { float leftEdgeX; int32_t texture; };
+    struct Obstacle_Record { b2Vec2 position; float width, height; int32_t texture; uint8_t scored; Obstacle_Kind kind; };
+    struct PowerUp_Record { b2Vec2 position; uint8_t type; };
 }
 
-void Game::InitializeSkins()
+void Game::Capture_Snapshot(vector<uint8_t>& out)
 {
-    // Define all the skins available in your game
-    m_allSkins.push_back({"player_default", "Default Alien", 0, true}); // The first skin is free and unlocked
-    m_allSkins.push_back({"player_green", "Green Alien", 100, false});
-    m_allSkins.push_back({"player_pink", "Pink Alien", 150, false});
-    // Add more skins here
-}
\ No newline at end of file
+    // Fields are written one by one, structs included, so padding never ends up in the buffer.
+    // Textures are stored as handles, which stay valid across reloads and evictions.
+    Snapshot_Writer writer(out);
+    writer.Write(SNAPSHOT_MAGIC);
+
+    writer.Write(m_score);
+    writer.Write(current_coins);
+    writer.Write(m_runSeconds);
+    writer.Write(m_Obstacle_Spawn_Timer);
+    writer.Write(m_tutorialTextTimer);
+    writer.Write(cameraX);
+    writer.Write(m_starLayerOffsets);
+    writer.Write(Animation_Clock::GetInstance().Now());
+
+    Write_Player_State(writer, m_Player->Get_State());
+
+    writer.Write(static_cast<uint32_t>(m_Ground_Segments.size()));
+    for (const auto& segment : m_Ground_Segments)
+    {
+        writer.Write(segment->Get_Left_EdgeX());
+        writer.Write(static_cast<int32_t>(segment->Get_Texture().index));
+    }
+
+    writer.Write(static_cast<uint32_t>(m_Obstacles.size()));
+    for (const auto& obstacle : m_Obstacles)
+    {
+        writer.Write(obstacle->get_position());
+        writer.Write(obstacle->GetWidthMeters() * PIXELS_PER_METER);
+        writer.Write(obstacle->GetHeightMeters() * PIXELS_PER_METER);
+        writer.Write(static_cast<int32_t>(obstacle->Get_Texture().index));
+        writer.Write(static_cast<uint8_t>(obstacle->Is_Scored()));
+        writer.Write(obstacle->Get_Kind());
+    }
+
+    writer.Write(static_cast<uint32_t>(m_powerUps.size()));
+    for (const auto& powerUp : m_powerUps)
+    {
+        writer.Write(powerUp->get_position());
+        writer.Write(static_cast<uint8_t>(powerUp->GetType()));
+    }
+
+    writer.Write(static_cast<uint32_t>(m_coins.size()));
+    for (const auto& coin : m_coins)
+    {
+        writer.Write(coin->get_position());
+    }
+}
+
+bool Game::Restore_Snapshot(const vector<uint8_t>& in)
+{
+    // Everything is read into locals first; the world is only released and respawned once the
+    // whole snapshot has parsed, so a short or damaged one leaves the game untouched
+    Snapshot_Reader reader(in.data(), in.size());
+
+    uint32_t magic = 0;
+    if (!reader.Read(magic) || magic != SNAPSHOT_MAGIC)
+    {
+        cerr << "Restore_Snapshot: not a world snapshot" << endl;
+        return false;
+    }
+
+    long int score, coins;
+    float runSeconds, spawnTimer, tutorialTimer, camera;
+    float starLayerOffsets[3];
+    double animationSeconds;
+    Player_State playerState;
+    bool valid = reader.Read(score) && reader.Read(coins) && reader.Read(runSeconds) && reader.Read(spawnTimer)
+                 && reader.Read(tutorialTimer) && reader.Read(camera) && reader.Read(starLayerOffsets)
+                 && reader.Read(animationSeconds)
+                 && Read_Player_State(reader, playerState);
+
+    uint32_t count = 0;
+    vector<Ground_Record> ground;
+    valid = valid && reader.Read(count);
+    for (uint32_t i = 0; valid && i < count; ++i)
+    {
+        Ground_Record record;
+        valid = reader.Read(record.leftEdgeX) && reader.Read(record.texture);
+        ground.push_back(record);
+    }
+
+    vector<Obstacle_Record> obstacles;
+    valid = valid && reader.Read(count);
+    for (uint32_t i = 0; valid && i < count; ++i)
+    {
+        Obstacle_Record record;
+        valid = reader.Read(record.position) && reader.Read(record.width) && reader.Read(record.height)
+                && reader.Read(record.texture) && reader.Read(record.scored) && reader.Read(record.kind)
+                && record.kind <= Obstacle_Kind::WIDE;
+        obstacles.push_back(record);
+    }
+
+    vector<PowerUp_Record> powerUps;
+    valid = valid && reader.Read(count);
+    for (uint32_t i = 0; valid && i < count; ++i)
+    {
+        PowerUp_Record record;
+        valid = reader.Read(record.position) && reader.Read(record.type)
+                && record.type <= static_cast<uint8_t>(PowerUpType::DOUBLE_SCORE);
+        powerUps.push_back(record);
+    }
+
+    vector<b2Vec2> coinPositions;
+    valid = valid && reader.Read(count);
+    for (uint32_t i = 0; valid && i < count; ++i)
+    {
+        b2Vec2 position;
+        valid = reader.Read(position);
+        coinPositions.push_back(position);
+    }
+
+    if (!valid)
+    {
+        cerr << "Restore_Snapshot: snapshot is truncated or damaged" << endl;
+        return false;
+    }
+
+    m_score = score;
+    current_coins = coins;
+    m_runSeconds = runSeconds;
+    m_Obstacle_Spawn_Timer = spawnTimer;
+    m_tutorialTextTimer = tutorialTimer;
+    cameraX = camera;
+    memcpy(m_starLayerOffsets, starLayerOffsets, sizeof(starLayerOffsets));
+    Animation_Clock::GetInstance().Set(animationSeconds);
+    m_Player->Set_State(playerState);
+
+    Release_All(m_Ground_Segments, m_groundPool);
+    Release_Entities();
+    m_particles.Clear();    // Cosmetic, so they aren't part of the snapshot
+    m_input.Clear();
+
+    for (const Ground_Record& record : ground)
+    {
+        Spawn_Ground(record.leftEdgeX, Texture_Handle{ record.texture });
+    }
+    for (const Obstacle_Record& record : obstacles)
+    {
+        Obstacle* obstacle = Spawn_Obstacle(record.position.x * PIXELS_PER_METER, record.position.y * PIXELS_PER_METER,
+                                            record.width, record.height, Texture_Handle{ record.texture }, record.kind);
+        obstacle->Set_Scored(record.scored != 0);
+    }
+    for (const PowerUp_Record& record : powerUps)
+    {
+        Spawn_PowerUp(static_cast<PowerUpType>(record.type), record.position.x, record.position.y);
+    }
+    for (const b2Vec2& position : coinPositions)
+    {
+        Spawn_Coin(position.x, position.y);
+    }
+
+    return true;
+}
+
+bool Game::Restore_Frame(uint32_t frame)
+{
+    vector<uint8_t> state;
+    if (!m_rewind.Restore(frame, state)) return false;
+    if (!Restore_Snapshot(state)) return false;
+
+    // The frames after it belonged to the attempt being replaced
+    m_rewind.Truncate_After(frame, state);
+    m_frameIndex = frame + 1;
+    return true;
+}
+
+bool Game::Has_Checkpoint() const
+{
+    uint32_t oldest;
+    return m_rewind.Oldest_Restorable(oldest);
+}
+
+bool Game::Retry_From_Checkpoint()
+{
+    uint32_t oldest, newest;
+    if (!m_rewind.Oldest_Restorable(oldest) || !m_rewind.Newest(newest)) return false;
+
+    uint32_t target = newest > oldest + CHECKPOINT_SECONDS * 60 ? newest - CHECKPOINT_SECONDS * 60 : oldest;
+
+    // The run stays open: it's recorded once, when this attempt ends and isn't retried
+    if (!Restore_Frame(target)) return false;
+    m_runUnrecorded = false;
+
+    cout << "Rewound to frame " << target << " (" << m_rewind.Stored_Bytes() / 1024 << " KB in rewind buffer)" << endl;
+    m_current_State = STATE::PLAYING;
+    return true;
+}
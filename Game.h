@@ -6,15 +6,63 @@
 #define ENDLESS_RUNNER_GAME_H
 
 #include "Object.h"
+#include "Rewind_Buffer.h"
+#include "Asset_Loader.h"
+#include "Asset_Archive.h"
+#include "Asset_Watcher.h"
+#include "Music_Player.h"
+#include "Async_Writer.h"
+#include "Profile_Store.h"
+#include "Run_History.h"
+#include "Frame_Profiler.h"
+#include "Alloc_Tracker.h"
+#include "Stress_Test.h"
+#include "Run_Telemetry.h"
+#include "Particle_System.h"
+#include "UI_Tree.h"
+#include "Input_Buffer.h"
+#include "Config.h"
+#include <filesystem>
+#include <initializer_list>
+#include <iterator>
 
 struct Skin {
     string id;            // The key used in the AssetManager (e.g., "player_default")
     string displayName;
     int price;
     bool isUnlocked = false;
+    Texture_Handle texture;   // Resolved from id once the skins are set up
 };
 
-enum class STATE { MAIN_MENU, PLAYING, GAME_OVER, SHOP };
+enum class STATE { LOADING, MAIN_MENU, PLAYING, GAME_OVER, SHOP };
+
+// Things that happen during a run, each with its sound and particle effect
+enum class Game_Event { COIN_PICKUP, POWER_UP, CRASH };
+
+void render_text(SDL_Renderer* renderer, TTF_Font* font, const string& text, int x, int y, SDL_Color color = { 200, 200, 200, 255 });
+
+// Menu screens, built once in Game::Build_UI; the ints are widget ids in the tree
+struct Main_Menu_UI
+{
+    UI_Tree tree;
+    int start = -1, shop = -1, quit = -1;
+    int medals[3] = { -1, -1, -1 };
+    int scores[5] = { -1, -1, -1, -1, -1 };
+};
+
+struct Game_Over_UI
+{
+    UI_Tree tree;
+    int score = -1, stats = -1;
+    int restart = -1, menu = -1, checkpoint = -1;
+};
+
+struct Shop_UI
+{
+    UI_Tree tree;
+    int previous = -1, current = -1, next = -1;
+    int name = -1, price = -1, button = -1, wallet = -1;
+};
 
 class Game
 {
@@ -28,55 +76,144 @@ private:
     TTF_Font* font_regular;
 
     bool running = true;
+    static const int TARGET_FPS = 60;       // One fixed simulation tick per frame
+    bool m_spinWait = false;                // ER_LOW_LATENCY or ER_INPUT_LATENCY: spin out the end of each frame wait
+
+    // Jump presses, held for the jump buffer and timed with ER_INPUT_LATENCY
+    Input_Buffer m_input;
+    bool m_showProfiler = false;    // F1
+    bool m_flushTrace = false;      // F2, with ER_TRACE set
+
+    // Startup, then evicted textures coming back
+    Asset_Loader m_loader;
+    static const int RELOAD_UPLOADS_PER_FRAME = 2;
+    Uint64 m_startupCounter = 0;
+    double m_firstFrameMs = -1.0;
+    Asset_Watcher m_watcher;
 
     float cameraX = 0.0f;
 
+    // Floating origin: once the player is this far out, everything is shifted back toward zero
+    const float REBASE_THRESHOLD_METERS = 1000.0f;
+    float m_starLayerOffsets[3] = { 0.0f, 0.0f, 0.0f };
+
     unique_ptr<Player> m_Player;
     deque<unique_ptr<Scenery>> m_Ground_Segments;
     deque<unique_ptr<Obstacle>> m_Obstacles;
     deque<unique_ptr<PowerUp>> m_powerUps;
     deque<unique_ptr<Coin>> m_coins;
 
+    // Parked entities, reused by the Spawn_ functions instead of creating new bodies
+    vector<unique_ptr<Scenery>> m_groundPool;
+    vector<unique_ptr<Obstacle>> m_obstaclePool;
+    vector<unique_ptr<PowerUp>> m_powerUpPool;
+    vector<unique_ptr<Coin>> m_coinPool;
+
     float m_Obstacle_Spawn_Timer = 0.0f;
 
     long int m_score = 0;
 
-    STATE m_current_State;
+    unsigned int m_runSeed = 0;
+    unsigned int m_runCount = 0;
+    double m_lastResetMs = 0.0;
+
+    STATE m_current_State = STATE::LOADING;
     vector<int> m_high_Scores;
 
-    vector<string> small_obstacle_skins;
-    vector<string> tall_obstacle_skins;
-    vector<string> wide_obstacle_skins;
+    // Every run, for the high score panel and run stats
+    Run_History m_history;
+    vector<int> m_panelScores;              // Top five, refreshed when a run is added
+    float m_runSeconds = 0.0f;
+    Death_Cause m_deathCause = Death_Cause::UNKNOWN;
+    bool m_runUnrecorded = false;           // Died, but a checkpoint retry could still continue the run
+
+    // Frame timing for each run, appended to a JSON Lines file when the run is recorded
+    Run_Telemetry m_telemetry;
+
+    // ER_AUTOPLAY_SECONDS: headless scripted play, e.g. to train the profile-guided build
+    float m_autoplaySeconds = 0.0f;
+    float m_autoplayElapsed = 0.0f;
+
+    // ER_STRESS_ runs: denser spawning, or a held entity count, with an invulnerable player
+    Stress_Test m_stress;
+    float m_stressCursorX = 0.0f;           // Where the next held entity goes, in pixels
+
+    // Scores, wallet and unlocks live in one profile file, written off the game thread
+    string m_profilePath;
+    Async_Writer m_profileWriter;
+
+    vector<Texture_Handle> small_obstacle_skins;
+    vector<Texture_Handle> tall_obstacle_skins;
+    vector<Texture_Handle> wide_obstacle_skins;
+
+    // Resolved once in the constructor, so per-frame code never looks names up
+    Texture_Handle m_coinTexture;
+    Texture_Handle m_groundTexture;
+    Texture_Handle m_medalTextures[3];
+    Sound_Handle m_clickSound;
+    Sound_Handle m_coinSound;
+    Sound_Handle m_powerUpSound;
+    Sound_Handle m_crashSound;
+
+    // Music
+    const float MUSIC_CROSSFADE_SECONDS = 1.5f;
+    string m_menuMusicPath;
+    string m_gameMusicPath;
+    string m_currentMusic;
 
     vector<vector<SDL_Point>> m_starLayers;
 
+    // Pickup and crash effects
+    static const int PARTICLE_CAPACITY = 8192;
+    Particle_System m_particles;
+    int m_sparkPool = -1;
+
     long int current_coins = 0;
     long int m_totalCoins = 0;
 
     float m_tutorialTextTimer = 5.0f;
 
-    int m_uiCoinFrameCount = 0;
-    int m_uiCoinCurrentFrame = 0;
-    int m_uiCoinFrameWidth = 0;
-    int m_uiCoinFrameHeight = 0;
-    float m_uiCoinAnimTimer = 0.0f;
-    float m_uiCoinAnimSpeed = 0.1f;
+    // Menus only change when what they show does, see the Refresh_ functions
+    Main_Menu_UI m_menuUI;
+    Game_Over_UI m_gameOverUI;
+    Shop_UI m_shopUI;
 
     std::vector<Skin> m_allSkins;
     int m_currentSkinIndex = 0; // Which skin is currently selected in the shop
     std::string m_equippedSkinId = "player_default";
+
+    // Rewind
+    static const int REWIND_SECONDS = 10;
+    static const int REWIND_KEYFRAME_INTERVAL = 30; // Full snapshot twice a second
+    static const int CHECKPOINT_SECONDS = 3;        // How far back "Retry Checkpoint" goes
+    Rewind_Buffer m_rewind{ REWIND_SECONDS * 60, REWIND_KEYFRAME_INTERVAL };
+    vector<uint8_t> m_snapshotScratch;
+    uint32_t m_frameIndex = 0;
 public:
     Game();
     void Run();
+    STATE Get_State() const { return m_current_State; }
 
     void Generate_Initial_Ground();
+    Scenery* Spawn_Ground(float startX, Texture_Handle texture);
+    Obstacle* Spawn_Obstacle(float x, float y, float width, float height, Texture_Handle texture, Obstacle_Kind kind);
+    PowerUp* Spawn_PowerUp(PowerUpType type, float x, float y);
+    Coin* Spawn_Coin(float x, float y);
+    void Release_Entities();
     void Update_Ground();
     void Update_Spawning(float deltaTime);
     void Update_Score();
     void Render_UI();
+    void Render_Profiler();
     void Reset_Game();
     void Render_Playing();
     void Update_Playing(float timeStep);
+    void Update_Collisions();
+    void Raise_Event(Game_Event event, b2Vec2 positionMeters);
+    Particle_System& Particles() { return m_particles; }
+    void Update_Stress();
+    void Update_Autoplay();
+    size_t Live_Entity_Count() const;
     void Update_GameOver(const SDL_Event& event);
     void Render_GameOver();
     void Update_MainMenu(const SDL_Event& event);
@@ -84,18 +221,37 @@ public:
     void HandleEvents_Playing(const SDL_Event& event);
     void HandleEvents_MainMenu(const SDL_Event& event);
     void HandleEvents_GameOver(const SDL_Event& event);
-    void Save_Scores();
-    void Load_Scores();
+    void Save_Profile();
+    void Load_Profile();
     void Update_High_Scores();
+    void Record_Run();
+    void Finish_Run();
+    void Resolve_Handles();
     void Load_Assets();
+    void Update_Loading();
+    void Render_Loading();
+    void Finish_Loading();
     void GenerateStars();
     void RenderStarfield();
-    void SaveWallet();
-    void LoadWallet();
+    void Update_Music();
+    void Rebase_Origin();
     void HandleEvents_Shop(const SDL_Event& event);
     void Render_Shop();
     void InitializeSkins();
     void UpdateShop();
+
+    // Menus
+    void Build_UI();
+    void Refresh_Score_Panel();
+    void Refresh_Game_Over_UI();
+    void Refresh_Shop_UI();
+
+    // Snapshots
+    void Capture_Snapshot(vector<uint8_t>& out);
+    bool Restore_Snapshot(const vector<uint8_t>& in);
+    bool Restore_Frame(uint32_t frame);
+    bool Has_Checkpoint() const;
+    bool Retry_From_Checkpoint();
 };
 
 
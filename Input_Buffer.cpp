@@ -0,0 +1,103 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Input_Buffer.h"
+#include "Config.h"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    const size_t LATENCY_SAMPLES = 4096;   // Reserved up front, so measuring never allocates mid-run
+
+    float Percentile(vector<float> samples, float fraction)
+    {
+        size_t index = min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+        nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+
+    void Print_Row(const char* name, const vector<float>& samples)
+    {
+        cout << "  " << name << ": p50 " << Percentile(samples, 0.5f) << " ms, p99 " << Percentile(samples, 0.99f)
+             << " ms, max " << *max_element(samples.begin(), samples.end()) << " ms" << endl;
+    }
+}
+
+void Input_Buffer::Configure()
+{
+    m_bufferSeconds = max(0, Config_Int("ER_JUMP_BUFFER_MS", 100)) / 1000.0f;
+    m_coyoteSeconds = max(0, Config_Int("ER_COYOTE_MS", 80)) / 1000.0f;
+
+    m_measure = Config_Flag("ER_INPUT_LATENCY");
+    if (m_measure)
+    {
+        m_pressToTickMs.reserve(LATENCY_SAMPLES);
+        m_pressToPresentMs.reserve(LATENCY_SAMPLES);
+        cout << "Input latency: measuring, jump buffer " << m_bufferSeconds * 1000.0f << " ms, coyote time " << m_coyoteSeconds * 1000.0f << " ms" << endl;
+    }
+}
+
+void Input_Buffer::Press(Uint32 timestampMs, float tickSeconds)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint32 ageMs = SDL_GetTicks() - timestampMs;
+
+    // Full buffer: the oldest press is the one closest to expiring anyway
+    if (m_count == MAX_PRESSES) Pop();
+
+    Pending_Press& press = m_presses[(m_first + m_count) % MAX_PRESSES];
+    press.simSeconds = m_simSeconds - min(ageMs / 1000.0f, tickSeconds);
+    press.counter = now - min<Uint64>(now, static_cast<Uint64>(ageMs) * SDL_GetPerformanceFrequency() / 1000);
+    m_count++;
+}
+
+void Input_Buffer::Pop()
+{
+    m_first = (m_first + 1) % MAX_PRESSES;
+    m_count--;
+}
+
+bool Input_Buffer::Take_Jump()
+{
+    while (m_count > 0 && m_simSeconds - m_presses[m_first].simSeconds > m_bufferSeconds)
+    {
+        Pop();
+    }
+    if (m_count == 0) return false;
+
+    const Pending_Press& press = m_presses[m_first];
+    if (m_measure && m_pressToTickMs.size() < LATENCY_SAMPLES)
+    {
+        Uint64 now = SDL_GetPerformanceCounter();
+        m_pressToTickMs.push_back(static_cast<float>((now - press.counter) * 1000.0 / SDL_GetPerformanceFrequency()));
+        m_appliedCounter = press.counter;
+    }
+    Pop();
+    return true;
+}
+
+void Input_Buffer::Frame_Presented()
+{
+    if (m_appliedCounter == 0) return;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    m_pressToPresentMs.push_back(static_cast<float>((now - m_appliedCounter) * 1000.0 / SDL_GetPerformanceFrequency()));
+    m_appliedCounter = 0;
+}
+
+void Input_Buffer::Print_Latency_Stats() const
+{
+    if (!m_measure) return;
+    if (m_pressToPresentMs.empty())
+    {
+        cout << "Input latency: no jumps measured" << endl;
+        return;
+    }
+
+    // Timestamps are SDL's millisecond event times, so every figure can be up to 1 ms short
+    cout << "Input latency over " << m_pressToPresentMs.size() << " jumps:" << endl;
+    Print_Row("press to tick", m_pressToTickMs);
+    Print_Row("press to present", m_pressToPresentMs);
+}
@@ -0,0 +1,67 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_INPUT_BUFFER_H
+#define ENDLESS_RUNNER_INPUT_BUFFER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+using namespace std;
+
+// Jump presses, stamped with SDL's event timestamp and placed on the simulation clock at the
+// tick they arrived during. A press the player can't act on yet (e.g. just before landing with
+// no jumps left) is kept for ER_JUMP_BUFFER_MS and taken by the first tick that can jump.
+// With ER_INPUT_LATENCY set, also times each buffered jump from the key press to the
+// SDL_RenderPresent of the frame it first moved the player in, and reports it at exit.
+class Input_Buffer
+{
+private:
+    struct Pending_Press
+    {
+        double simSeconds;      // When it happened, on the simulation clock
+        Uint64 counter;         // When it happened, on the performance counter
+    };
+
+    static const int MAX_PRESSES = 8;
+    Pending_Press m_presses[MAX_PRESSES];
+    int m_first = 0;
+    int m_count = 0;
+
+    double m_simSeconds = 0.0;  // Start of the tick being simulated
+    float m_bufferSeconds = 0.1f;
+    float m_coyoteSeconds = 0.08f;
+
+    // ER_INPUT_LATENCY
+    bool m_measure = false;
+    vector<float> m_pressToTickMs;
+    vector<float> m_pressToPresentMs;
+    Uint64 m_appliedCounter = 0;    // Press behind this frame's jump, 0 if none
+
+    void Pop();
+public:
+    // Reads ER_JUMP_BUFFER_MS, ER_COYOTE_MS and ER_INPUT_LATENCY
+    void Configure();
+    float Coyote_Seconds() const { return m_coyoteSeconds; }
+
+    // From the event loop. The press happened during the tick about to run, at most tickSeconds ago.
+    void Press(Uint32 timestampMs, float tickSeconds);
+
+    // Pops the oldest press still inside the buffer window. Only ask when the player can jump.
+    bool Take_Jump();
+
+    // After each simulated tick
+    void Tick(float deltaTime) { m_simSeconds += deltaTime; }
+
+    // New runs and rewinds start with nothing pending
+    void Clear() { m_first = 0; m_count = 0; }
+
+    // Right after SDL_RenderPresent
+    void Frame_Presented();
+
+    void Print_Latency_Stats() const;
+};
+
+
+#endif //ENDLESS_RUNNER_INPUT_BUFFER_H
@@ -0,0 +1,40 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_MAPPED_FILE_H
+#define ENDLESS_RUNNER_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Read-only memory mapping of a whole file
+class Mapped_File
+{
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+public:
+    Mapped_File() {}
+    ~Mapped_File() { Close(); }
+
+    Mapped_File(const Mapped_File&) = delete;
+    Mapped_File& operator=(const Mapped_File&) = delete;
+
+    bool Open(const string& path);
+    void Close();
+
+    bool Is_Open() const { return m_data != nullptr; }
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+};
+
+
+#endif //ENDLESS_RUNNER_MAPPED_FILE_H
@@ -0,0 +1,193 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Music_Decoder.h"
+#include "Asset_Archive.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef ER_HAVE_VORBIS
+#include <vorbis/vorbisfile.h>
+#endif
+
+// Wav_Decoder: plain PCM, read straight through the file
+
+class Wav_Decoder : public Music_Decoder
+{
+private:
+    SDL_RWops* m_source;
+    Sint64 m_dataStart = 0;
+    Sint64 m_dataEnd = 0;
+    Sint64 m_position = 0;
+public:
+    explicit Wav_Decoder(SDL_RWops* source) : m_source(source) {}
+    ~Wav_Decoder() override { SDL_RWclose(m_source); }
+
+    bool Open()
+    {
+        uint8_t header[12];
+        if (SDL_RWread(m_source, header, 1, sizeof(header)) != sizeof(header)) return false;
+        if (memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) return false;
+
+        bool haveFormat = false;
+        uint8_t chunk[8];
+        while (SDL_RWread(m_source, chunk, 1, sizeof(chunk)) == sizeof(chunk))
+        {
+            uint32_t size = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | (static_cast<uint32_t>(chunk[7]) << 24);
+
+            if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+            {
+                uint8_t format[16];
+                if (SDL_RWread(m_source, format, 1, sizeof(format)) != sizeof(format)) return false;
+
+                uint16_t encoding = format[0] | (format[1] << 8);
+                uint16_t bits = format[14] | (format[15] << 8);
+                m_channels = format[2] | (format[3] << 8);
+                m_rate = format[4] | (format[5] << 8) | (format[6] << 16) | (format[7] << 24);
+
+                if (encoding != 1 || (bits != 16 && bits != 8))
+                {
+                    cerr << "Music: only 8 and 16-bit PCM wav is supported" << endl;
+                    return false;
+                }
+                m_format = (bits == 16) ? AUDIO_S16LSB : AUDIO_U8;
+                haveFormat = true;
+
+                SDL_RWseek(m_source, (size - 16) + (size & 1), RW_SEEK_CUR);
+            }
+            else if (memcmp(chunk, "data", 4) == 0)
+            {
+                m_dataStart = SDL_RWtell(m_source);
+                m_dataEnd = m_dataStart + size;
+                m_position = m_dataStart;
+                return haveFormat;
+            }
+            else
+            {
+                SDL_RWseek(m_source, size + (size & 1), RW_SEEK_CUR);
+            }
+        }
+        return false;
+    }
+
+    int Read(uint8_t* buffer, int size) override
+    {
+        Sint64 count = min<Sint64>(size, m_dataEnd - m_position);
+        if (count <= 0) return 0;
+
+        size_t read = SDL_RWread(m_source, buffer, 1, static_cast<size_t>(count));
+        m_position += read;
+        return static_cast<int>(read);
+    }
+
+    bool Rewind() override
+    {
+        m_position = m_dataStart;
+        return SDL_RWseek(m_source, m_dataStart, RW_SEEK_SET) == m_dataStart;
+    }
+};
+
+#ifdef ER_HAVE_VORBIS
+
+// Vorbis_Decoder: libvorbisfile reading through the same SDL_RWops as everything else
+
+class Vorbis_Decoder : public Music_Decoder
+{
+private:
+    SDL_RWops* m_source;
+    OggVorbis_File m_file;
+    bool m_isOpen = false;
+
+    static size_t Read_Callback(void* data, size_t size, size_t count, void* source)
+    {
+        return SDL_RWread(static_cast<SDL_RWops*>(source), data, size, count);
+    }
+
+    static int Seek_Callback(void* source, ogg_int64_t offset, int whence)
+    {
+        int mode = (whence == SEEK_SET) ? RW_SEEK_SET : (whence == SEEK_CUR) ? RW_SEEK_CUR : RW_SEEK_END;
+        return SDL_RWseek(static_cast<SDL_RWops*>(source), offset, mode) < 0 ? -1 : 0;
+    }
+
+    static long Tell_Callback(void* source)
+    {
+        return static_cast<long>(SDL_RWtell(static_cast<SDL_RWops*>(source)));
+    }
+public:
+    explicit Vorbis_Decoder(SDL_RWops* source) : m_source(source) {}
+    ~Vorbis_Decoder() override
+    {
+        if (m_isOpen) ov_clear(&m_file);
+        SDL_RWclose(m_source);
+    }
+
+    bool Open()
+    {
+        // The source stays ours; close_func is null so ov_clear leaves it alone
+        ov_callbacks callbacks = { Read_Callback, Seek_Callback, nullptr, Tell_Callback };
+        if (ov_open_callbacks(m_source, &m_file, nullptr, 0, callbacks) != 0) return false;
+        m_isOpen = true;
+
+        vorbis_info* info = ov_info(&m_file, -1);
+        m_channels = info->channels;
+        m_rate = static_cast<int>(info->rate);
+        m_format = AUDIO_S16LSB;
+        return true;
+    }
+
+    int Read(uint8_t* buffer, int size) override
+    {
+        int total = 0;
+        while (total < size)
+        {
+            int section;
+            long read = ov_read(&m_file, reinterpret_cast<char*>(buffer + total), size - total, 0, 2, 1, &section);
+            if (read <= 0) break;
+            total += static_cast<int>(read);
+        }
+        return total;
+    }
+
+    bool Rewind() override
+    {
+        return ov_raw_seek(&m_file, 0) == 0;
+    }
+};
+
+#endif
+
+unique_ptr<Music_Decoder> Open_Music_Decoder(const string& name, const string& path)
+{
+    SDL_RWops* source = Asset_Archive::GetInstance().Open_Entry(name);
+    if (!source) source = SDL_RWFromFile(path.c_str(), "rb");
+    if (!source)
+    {
+        cerr << "Music: failed to open " << path << " | Error: " << SDL_GetError() << endl;
+        return nullptr;
+    }
+
+    string extension = path.substr(path.find_last_of('.') + 1);
+    transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    if (extension == "wav")
+    {
+        auto decoder = make_unique<Wav_Decoder>(source);
+        if (decoder->Open()) return decoder;
+    }
+#ifdef ER_HAVE_VORBIS
+    else if (extension == "ogg")
+    {
+        auto decoder = make_unique<Vorbis_Decoder>(source);
+        if (decoder->Open()) return decoder;
+    }
+#endif
+    else
+    {
+        SDL_RWclose(source);
+    }
+
+    cerr << "Music: can't decode " << path << endl;
+    return nullptr;
+}
@@ -0,0 +1,41 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_MUSIC_DECODER_H
+#define ENDLESS_RUNNER_MUSIC_DECODER_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+// Pulls a compressed track apart a block at a time, so a multi-minute song
+// never has to sit in memory fully decoded
+class Music_Decoder
+{
+protected:
+    SDL_AudioFormat m_format = AUDIO_S16LSB;
+    int m_channels = 2;
+    int m_rate = 44100;
+public:
+    virtual ~Music_Decoder() {}
+
+    // Native format of what Read() returns
+    SDL_AudioFormat Format() const { return m_format; }
+    int Channels() const { return m_channels; }
+    int Rate() const { return m_rate; }
+
+    // Decode up to size bytes. Returns the number written, 0 at the end of the track.
+    virtual int Read(uint8_t* buffer, int size) = 0;
+    virtual bool Rewind() = 0;
+};
+
+// Opens the track from the asset archive if it's packed there, otherwise from disk.
+// Picks the decoder by extension; returns nullptr if the file or format isn't usable.
+unique_ptr<Music_Decoder> Open_Music_Decoder(const string& name, const string& path);
+
+
+#endif //ENDLESS_RUNNER_MUSIC_DECODER_H
@@ -0,0 +1,334 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Music_Player.h"
+#include "Trace_Recorder.h"
+#include <algorithm>
+#include <iostream>
+
+// Sample_Ring
+
+void Sample_Ring::Reset(size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+
+    m_samples.assign(size, 0);
+    m_mask = size - 1;
+    m_read = 0;
+    m_write = 0;
+}
+
+size_t Sample_Ring::Write(const int16_t* data, size_t count)
+{
+    size_t write = m_write.load(memory_order_relaxed);
+    size_t read = m_read.load(memory_order_acquire);
+    count = min(count, m_samples.size() - (write - read));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_samples[(write + i) & m_mask] = data[i];
+    }
+    m_write.store(write + count, memory_order_release);
+    return count;
+}
+
+size_t Sample_Ring::Read(int16_t* data, size_t count)
+{
+    size_t read = m_read.load(memory_order_relaxed);
+    size_t write = m_write.load(memory_order_acquire);
+    count = min(count, write - read);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        data[i] = m_samples[(read + i) & m_mask];
+    }
+    m_read.store(read + count, memory_order_release);
+    return count;
+}
+
+// Music_Player
+
+bool Music_Player::Init(float volume)
+{
+    int rate, channels;
+    Uint16 format;
+    if (!Mix_QuerySpec(&rate, &format, &channels))
+    {
+        cerr << "Music: mixer isn't open" << endl;
+        return false;
+    }
+    if (format != AUDIO_S16SYS)
+    {
+        cerr << "Music: needs a 16-bit mixer, music disabled" << endl;
+        return false;
+    }
+
+    m_rate = rate;
+    m_channels = channels;
+    m_volume = volume;
+
+    size_t ringSamples = static_cast<size_t>(m_rate) * m_channels * RING_MILLISECONDS / 1000;
+    for (Deck& deck : m_decks)
+    {
+        deck.ring.Reset(ringSamples);
+    }
+
+    m_decodeBuffer.resize(BLOCK_SAMPLES * 2);
+    m_convertBuffer.resize(BLOCK_SAMPLES);
+    m_deckBuffer.resize(BLOCK_SAMPLES);
+    m_mixBuffer.resize(BLOCK_SAMPLES);
+
+    m_running = true;
+    m_thread = thread(&Music_Player::Thread_Main, this);
+    Mix_HookMusic(&Music_Player::Mix_Callback, this);
+    return true;
+}
+
+void Music_Player::Play(const string& name, const string& path, float fadeSeconds)
+{
+    lock_guard<mutex> lock(m_commandMutex);
+    m_commands.push_back({ name, path, fadeSeconds, false });
+}
+
+void Music_Player::Stop(float fadeSeconds)
+{
+    lock_guard<mutex> lock(m_commandMutex);
+    m_commands.push_back({ "", "", fadeSeconds, true });
+}
+
+void Music_Player::Rehook()
+{
+    if (m_running) Mix_HookMusic(&Music_Player::Mix_Callback, this);
+}
+
+void Music_Player::Shutdown()
+{
+    if (!m_running) return;
+
+    Mix_HookMusic(nullptr, nullptr);
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+
+    for (Deck& deck : m_decks)
+    {
+        deck.active = false;
+        Release(deck);
+    }
+}
+
+// Decoder thread
+
+void Music_Player::Thread_Main()
+{
+    ER_TRACE_THREAD("Music decoder");
+
+    while (m_running)
+    {
+        // Commands run outside the lock, so Play() never waits on a file being opened
+        while (true)
+        {
+            Command command;
+            {
+                lock_guard<mutex> lock(m_commandMutex);
+                if (m_commands.empty()) break;
+                command = m_commands.front();
+                m_commands.pop_front();
+            }
+
+            if (!Run_Command(command))
+            {
+                // Waiting for a deck to free up; keep it first in line
+                lock_guard<mutex> lock(m_commandMutex);
+                m_commands.push_front(command);
+                break;
+            }
+        }
+
+        bool worked = false;
+        for (Deck& deck : m_decks)
+        {
+            if (deck.active) worked |= Fill(deck);
+            else if (deck.decoder) Release(deck);
+        }
+
+        // The rings hold half a second, so a short nap never starves the mixer
+        if (!worked) this_thread::sleep_for(chrono::milliseconds(5));
+    }
+}
+
+bool Music_Player::Run_Command(const Command& command)
+{
+    float fadeStep = (command.fadeSeconds > 0.0f) ? 1.0f / (command.fadeSeconds * m_rate) : 1.0f;
+
+    if (command.stop)
+    {
+        for (Deck& deck : m_decks)
+        {
+            deck.fadeStep = fadeStep;
+            deck.target = 0.0f;
+        }
+        return true;
+    }
+
+    // Already playing (or fading in) this track
+    for (Deck& deck : m_decks)
+    {
+        if (deck.active && deck.track == command.name && deck.target > 0.0f) return true;
+    }
+
+    Deck* incoming = nullptr;
+    for (Deck& deck : m_decks)
+    {
+        if (!deck.active)
+        {
+            incoming = &deck;
+            break;
+        }
+    }
+
+    if (!incoming)
+    {
+        // Both decks busy mid-crossfade: cut the one fading out and try again next pass
+        for (Deck& deck : m_decks)
+        {
+            if (deck.target == 0.0f) deck.fadeStep = 1.0f;
+        }
+        return false;
+    }
+
+    Release(*incoming);
+    incoming->decoder = Open_Music_Decoder(command.name, command.path);
+    if (!incoming->decoder) return true;
+
+    const Music_Decoder& decoder = *incoming->decoder;
+    incoming->stream = SDL_NewAudioStream(decoder.Format(), decoder.Channels(), decoder.Rate(), AUDIO_S16SYS, m_channels, m_rate);
+    if (!incoming->stream)
+    {
+        cerr << "Music: can't convert " << command.path << " | Error: " << SDL_GetError() << endl;
+        Release(*incoming);
+        return true;
+    }
+
+    incoming->track = command.name;
+    incoming->ended = false;
+    incoming->producedSinceRewind = false;
+    incoming->ring.Reset(static_cast<size_t>(m_rate) * m_channels * RING_MILLISECONDS / 1000);
+    Fill(*incoming);
+
+    for (Deck& deck : m_decks)
+    {
+        deck.fadeStep = fadeStep;
+        deck.target = (&deck == incoming) ? 1.0f : 0.0f;
+    }
+    incoming->active = true;
+    return true;
+}
+
+bool Music_Player::Fill(Deck& deck)
+{
+    ER_TRACE_SCOPE("Decode music");
+    bool worked = false;
+    while (deck.ring.Free() >= m_convertBuffer.size())
+    {
+        int wanted = static_cast<int>(m_convertBuffer.size() * sizeof(int16_t));
+        if (SDL_AudioStreamAvailable(deck.stream) < wanted && !deck.ended)
+        {
+            int read = deck.decoder->Read(m_decodeBuffer.data(), static_cast<int>(m_decodeBuffer.size()));
+            if (read > 0)
+            {
+                SDL_AudioStreamPut(deck.stream, m_decodeBuffer.data(), read);
+                deck.producedSinceRewind = true;
+            }
+            else if (deck.producedSinceRewind && deck.decoder->Rewind())
+            {
+                // Loop
+                deck.producedSinceRewind = false;
+            }
+            else
+            {
+                SDL_AudioStreamFlush(deck.stream);
+                deck.ended = true;
+            }
+            continue;
+        }
+
+        int got = SDL_AudioStreamGet(deck.stream, m_convertBuffer.data(), wanted);
+        if (got <= 0) break;
+
+        deck.ring.Write(m_convertBuffer.data(), got / sizeof(int16_t));
+        worked = true;
+    }
+    return worked;
+}
+
+void Music_Player::Release(Deck& deck)
+{
+    deck.decoder.reset();
+    if (deck.stream) SDL_FreeAudioStream(deck.stream);
+    deck.stream = nullptr;
+    deck.track.clear();
+}
+
+// Mixer thread
+
+void Music_Player::Mix_Callback(void* userdata, Uint8* stream, int length)
+{
+    Music_Player* player = static_cast<Music_Player*>(userdata);
+    int16_t* out = reinterpret_cast<int16_t*>(stream);
+    int samples = length / static_cast<int>(sizeof(int16_t));
+
+    // The mixer may ask for more than one scratch block at a time
+    while (samples > 0)
+    {
+        int count = min(samples, static_cast<int>(player->m_mixBuffer.size()));
+        count -= count % player->m_channels;
+        player->Mix(out, count);
+        out += count;
+        samples -= count;
+    }
+}
+
+void Music_Player::Mix(int16_t* out, int samples)
+{
+    fill(m_mixBuffer.begin(), m_mixBuffer.begin() + samples, 0);
+
+    for (Deck& deck : m_decks)
+    {
+        if (!deck.active) continue;
+
+        int read = static_cast<int>(deck.ring.Read(m_deckBuffer.data(), samples));
+        if (read < samples)
+        {
+            if (!deck.ended) m_underruns++;
+            fill(m_deckBuffer.begin() + read, m_deckBuffer.begin() + samples, 0);
+        }
+
+        float target = deck.target;
+        float step = deck.fadeStep;
+        for (int frame = 0; frame < samples; frame += m_channels)
+        {
+            if (deck.gain < target) deck.gain = min(target, deck.gain + step);
+            else if (deck.gain > target) deck.gain = max(target, deck.gain - step);
+
+            float gain = deck.gain * m_volume;
+            for (int channel = 0; channel < m_channels; ++channel)
+            {
+                m_mixBuffer[frame + channel] += static_cast<int32_t>(m_deckBuffer[frame + channel] * gain);
+            }
+        }
+
+        // Faded out, or played to the end: hand the deck back to the decoder thread
+        if ((deck.gain == 0.0f && target == 0.0f) || (deck.ended && deck.ring.Available() == 0))
+        {
+            deck.gain = 0.0f;
+            deck.active = false;
+        }
+    }
+
+    for (int i = 0; i < samples; ++i)
+    {
+        out[i] = static_cast<int16_t>(clamp(m_mixBuffer[i], -32768, 32767));
+    }
+}
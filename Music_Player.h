@@ -0,0 +1,120 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_MUSIC_PLAYER_H
+#define ENDLESS_RUNNER_MUSIC_PLAYER_H
+
+#include "Music_Decoder.h"
+#include <SDL2/SDL_mixer.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Single producer / single consumer ring of samples. The decoder thread writes, the mixer reads.
+class Sample_Ring
+{
+private:
+    vector<int16_t> m_samples;
+    size_t m_mask = 0;
+    atomic<size_t> m_read{0};
+    atomic<size_t> m_write{0};
+public:
+    // Only while nobody is reading or writing. Capacity is rounded up to a power of two.
+    void Reset(size_t capacity);
+
+    size_t Available() const { return m_write.load(memory_order_acquire) - m_read.load(memory_order_relaxed); }
+    size_t Free() const { return m_samples.size() - (m_write.load(memory_order_relaxed) - m_read.load(memory_order_acquire)); }
+
+    size_t Write(const int16_t* data, size_t count);
+    size_t Read(int16_t* data, size_t count);
+};
+
+// Streams background music: a worker thread decodes small blocks into one ring per deck,
+// and a Mix_HookMusic callback mixes the decks. Two decks allow a crossfade between tracks.
+// Memory is the two rings plus a few scratch blocks, whatever the track length.
+class Music_Player
+{
+private:
+    Music_Player() {}
+    ~Music_Player() {}
+
+    static const int RING_MILLISECONDS = 500;
+    static const int BLOCK_SAMPLES = 4096;
+
+    struct Deck
+    {
+        // Decoder thread only
+        unique_ptr<Music_Decoder> decoder;
+        SDL_AudioStream* stream = nullptr;  // Converts the track's format and rate to the mixer's
+        string track;
+        bool producedSinceRewind = false;
+
+        Sample_Ring ring;
+        atomic<bool> active{false};         // Set by the decoder thread once primed, cleared by the mixer
+        atomic<bool> ended{false};          // No more samples are coming
+        atomic<float> target{0.0f};
+        atomic<float> fadeStep{1.0f};       // Gain change per sample frame
+
+        float gain = 0.0f;                  // Mixer thread only
+    };
+
+    struct Command
+    {
+        string name;
+        string path;
+        float fadeSeconds;
+        bool stop;
+    };
+
+    Deck m_decks[2];
+
+    mutex m_commandMutex;
+    deque<Command> m_commands;
+
+    thread m_thread;
+    atomic<bool> m_running{false};
+
+    int m_rate = 44100;
+    int m_channels = 2;
+    float m_volume = 0.5f;
+    atomic<int> m_underruns{0};
+
+    // Scratch, sized once in Init
+    vector<uint8_t> m_decodeBuffer;   // Decoder thread
+    vector<int16_t> m_convertBuffer;  // Decoder thread
+    vector<int16_t> m_deckBuffer;     // Mixer thread
+    vector<int32_t> m_mixBuffer;      // Mixer thread
+
+    static void Mix_Callback(void* userdata, Uint8* stream, int length);
+    void Mix(int16_t* out, int samples);
+
+    void Thread_Main();
+    bool Run_Command(const Command& command);
+    bool Fill(Deck& deck);
+    void Release(Deck& deck);
+public:
+    static Music_Player& GetInstance()
+    {
+        static Music_Player instance;
+        return instance;
+    }
+
+    // After Mix_OpenAudio. Starts the decoder thread and hooks the mixer.
+    bool Init(float volume);
+
+    // Crossfade to a track (looping). Returns right away; opening and decoding happen on the worker.
+    void Play(const string& name, const string& path, float fadeSeconds);
+    void Stop(float fadeSeconds);
+
+    // Mix_CloseAudio drops the hook; call after the device is reopened
+    void Rehook();
+
+    void Shutdown();
+    int Underruns() const { return m_underruns; }
+};
+
+
+#endif //ENDLESS_RUNNER_MUSIC_PLAYER_H
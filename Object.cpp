@@ -3,6 +3,7 @@
 //
 
 #include "Object.h"
+#include <cstring>
 
 // helper
 
@@ -49,32 +50,37 @@ Object::~Object()
     }
 }
 
+void Object::Activate(b2Vec2 position)
+{
+    b2Body_SetTransform(Body_Id, position, b2Rot_identity);
+    b2Body_Enable(Body_Id);
+}
+
+void Object::Deactivate()
+{
+    // Disabled bodies leave the broad-phase, so parked objects cost the simulation nothing
+    b2Body_Disable(Body_Id);
+}
+
+void Object::Shift_Origin(b2Vec2 offset)
+{
+    b2Vec2 position = b2Body_GetPosition(Body_Id);
+    b2Body_SetTransform(Body_Id, { position.x - offset.x, position.y - offset.y }, b2Body_GetRotation(Body_Id));
+}
+
 // Player
 
 Player::Player(b2WorldId worldId)
 {
     m_currentSkin = "player_default";
-    m_texture = Asset_Manager::GetInstance().GetTexture(m_currentSkin);
-    if (m_texture == nullptr) return;
+    m_texture = Asset_Manager::GetInstance().GetHandle(m_currentSkin);
+    m_jumpSound = Audio_Manager::GetInstance().GetHandle("jump");
 
-    // Set animation properties
-    m_frameCount = 2; // The Kenney sprite sheet you showed has 11 frames of walking
-    m_currentFrame = 0;
-    m_animTimer = 0.0f;
-    m_animSpeed = 0.08f; // Display each frame for 0.08 seconds (~12 FPS animation)
+    SDL_Texture* texture = Asset_Manager::GetInstance().GetTexture(m_texture);
+    if (texture == nullptr) return;
 
-    if (m_texture)
-    {
-        // Query the texture to get its total width and height
-        int textureWidth, textureHeight;
-        SDL_QueryTexture(m_texture, NULL, NULL, &textureWidth, &textureHeight);
-
-        // Calculate the width of a single frame
-//        m_frameWidth = textureWidth / m_frameCount;
-//        m_frameHeight = textureHeight; // Since all frames are in one row
-        m_frameWidth = 69;
-        m_frameHeight = 94;
-    }
+    // Frame sizes on the sprite sheet are part of the clips, see Animation.cpp
+    m_animPhase = Animation_Clock::GetInstance().Start_Phase(Get_Clip(m_clip));
 
     is_Dead = false;
     m_jumps_Left = 2;
@@ -120,8 +126,9 @@ void Player::Jump()
     velocity.y = -20.0f;
     b2Body_SetLinearVelocity(Body_Id, velocity);
 
-    Audio_Manager::GetInstance().PlaySound("jump");
+    Audio_Manager::GetInstance().PlaySound(m_jumpSound);
     m_jumps_Left--;
+    m_groundJumpUsed = true;
 }
 
 void Player::Move_Right()
@@ -192,12 +199,22 @@ void Player::Update(b2WorldId worldId, float deltaTime, int score)
             {
                 m_jumps_Left = MAX_JUMPS;
             }
+            m_airSeconds = 0.0f;
+            m_groundJumpUsed = false;
         }
     }
     else // The player is in the air
     {
         b2Vec2 velocity = b2Body_GetLinearVelocity(Body_Id);
 
+        // Ran off an edge without jumping: once coyote time is up, only the air jumps are left
+        m_airSeconds += deltaTime;
+        if (!m_groundJumpUsed && m_airSeconds > m_coyoteSeconds)
+        {
+            m_groundJumpUsed = true;
+            if (m_jumps_Left > 0) m_jumps_Left--;
+        }
+
         if (velocity.y < -0.1f) // Moving upwards (jumping)
         {
             SetAnimation(AnimationState::JUMPING);
@@ -208,25 +225,6 @@ void Player::Update(b2WorldId worldId, float deltaTime, int score)
         }
     }
 
-    if (m_animState == AnimationState::RUNNING)
-    {
-        m_animTimer += deltaTime;
-        if (m_animTimer >= m_animSpeed)
-        {
-            // Move to the next frame
-            m_currentFrame++;
-
-            // If we've passed the last frame, loop back to the first
-            if (m_currentFrame >= m_frameCount)
-            {
-                m_currentFrame = 0;
-            }
-
-            // Reset the timer for the next frame
-            m_animTimer -= m_animSpeed;
-        }
-    }
-
     if (m_extraJumpTimer > 0)
     {
         m_extraJumpTimer -= deltaTime;
@@ -240,14 +238,11 @@ void Player::Update(b2WorldId worldId, float deltaTime, int score)
 
 void Player::Render(SDL_Renderer* renderer, float cameraX)
 {
-    if (m_texture == nullptr) return;
+    SDL_Texture* texture = Asset_Manager::GetInstance().GetTexture(m_texture);
+    if (texture == nullptr) return;
 
-    SDL_Rect srcRect;
-    srcRect.x = m_currentFrame * m_frameWidth; // Calculate X position on the sprite sheet
-//    srcRect.y = 0;                             // Top of the sheet
-    srcRect.y = m_animRow * m_frameHeight + 4;
-    srcRect.w = m_frameWidth;                  // Width of a single frame
-    srcRect.h = m_frameHeight;                 // Height of a single frame
+    const Animation_Clip& clip = Get_Clip(m_clip);
+    SDL_Rect srcRect = clip.Source_Rect(texture, Animation_Clock::GetInstance().Frame(clip, m_animPhase));
 
 
     const float PLAYER_WIDTH_PX = 50.0f;
@@ -262,7 +257,7 @@ void Player::Render(SDL_Renderer* renderer, float cameraX)
     };
 
     //SDL_RenderCopy(renderer, m_texture, NULL, &player_rect);
-    SDL_RenderCopy(renderer, m_texture, &srcRect, &player_rect);
+    SDL_RenderCopy(renderer, texture, &srcRect, &player_rect);
 
 
 //    SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
@@ -279,14 +274,62 @@ float Player::Get_Radius_Meters() const
 void Player::Reset()
 {
     b2Vec2 startPosition = { 300.0f / PIXELS_PER_METER, 700.0f / PIXELS_PER_METER };
-    //b2Body_SetTransform(Body_Id, startPosition, 0.0f); // Set position and angle
+    b2Body_SetTransform(Body_Id, startPosition, b2Rot_identity); // Set position and angle
     b2Body_SetLinearVelocity(Body_Id, b2Vec2_zero);    // Stop all movement
     b2Body_SetAngularVelocity(Body_Id, 0.0f);          // Stop all rotation
 
     m_extraJumpTimer = 0.0f;
     m_doubleScoreTimer = 0.0f;
+    PLAYER_SPEED = BASE_SPEED;
 
     m_jumps_Left = MAX_JUMPS;
+    m_airSeconds = 0.0f;
+    m_groundJumpUsed = false;
+    is_Dead = false;
+
+    m_animState = AnimationState::RUNNING;
+    m_clip = Clip_Id::PLAYER_RUN;
+    m_animPhase = Animation_Clock::GetInstance().Start_Phase(Get_Clip(m_clip));
+}
+
+Player_State Player::Get_State() const
+{
+    Player_State state = {};
+    state.position = b2Body_GetPosition(Body_Id);
+    state.velocity = b2Body_GetLinearVelocity(Body_Id);
+    state.isDead = is_Dead;
+    state.jumpsLeft = m_jumps_Left;
+    state.airSeconds = m_airSeconds;
+    state.groundJumpUsed = m_groundJumpUsed;
+    state.doubleScoreTimer = m_doubleScoreTimer;
+    state.extraJumpTimer = m_extraJumpTimer;
+    state.speed = PLAYER_SPEED;
+    state.animState = static_cast<int>(m_animState);
+    state.animPhase = m_animPhase;
+    return state;
+}
+
+void Player::Set_State(const Player_State& state)
+{
+    b2Body_SetTransform(Body_Id, state.position, b2Rot_identity);
+    b2Body_SetLinearVelocity(Body_Id, state.velocity);
+    b2Body_SetAngularVelocity(Body_Id, 0.0f);
+
+    is_Dead = state.isDead;
+    m_jumps_Left = state.jumpsLeft;
+    m_airSeconds = state.airSeconds;
+    m_groundJumpUsed = state.groundJumpUsed;
+    m_doubleScoreTimer = state.doubleScoreTimer;
+    m_extraJumpTimer = state.extraJumpTimer;
+    PLAYER_SPEED = state.speed;
+    m_animState = static_cast<AnimationState>(state.animState);
+    m_animPhase = state.animPhase;
+    switch (m_animState)
+    {
+        case AnimationState::RUNNING: m_clip = Clip_Id::PLAYER_RUN; break;
+        case AnimationState::JUMPING: m_clip = Clip_Id::PLAYER_JUMP; break;
+        case AnimationState::FALLING: m_clip = Clip_Id::PLAYER_FALL; break;
+    }
 }
 
 void Player::ActivatePowerUp(PowerUpType type)
@@ -312,27 +355,22 @@ void Player::SetAnimation(AnimationState state)
     switch (m_animState)
     {
         case AnimationState::RUNNING:
-            m_animRow = 2;      // 3rd row
-            m_frameCount = 2;   // 2 frames
-            m_animSpeed = 0.2f;
+            m_clip = Clip_Id::PLAYER_RUN;
             break;
         case AnimationState::JUMPING:
-            m_animRow = 3;      // 4th row
-            m_currentFrame = 1; // 2nd frame on that row
-            m_frameCount = 1;   // It's a single static frame
+            m_clip = Clip_Id::PLAYER_JUMP;
             cout << "JUMPED" << endl;
             break;
         case AnimationState::FALLING:
-            m_animRow = 3;      // 4th row
-            m_currentFrame = 0; // 1st frame on that row
-            m_frameCount = 1;   // Also a single static frame
+            m_clip = Clip_Id::PLAYER_FALL;
             break;
     }
+    m_animPhase = Animation_Clock::GetInstance().Start_Phase(Get_Clip(m_clip));
 }
 
 // Scenery
 
-Scenery::Scenery(b2WorldId worldId, float startX, SDL_Texture* texture)
+Scenery::Scenery(b2WorldId worldId, float startX, Texture_Handle texture)
 {
     m_texture = texture;
 
@@ -373,11 +411,12 @@ void Scenery::Update(b2WorldId worldId, float deltaTime, int score)
 
 void Scenery::Render(SDL_Renderer* renderer, float cameraX)
 {
-    if (m_texture == nullptr) return;
+    SDL_Texture* texture = Asset_Manager::GetInstance().GetTexture(m_texture);
+    if (texture == nullptr) return;
 
     // Get the dimensions of a single tile from the texture
     int tileWidth, tileHeight;
-    SDL_QueryTexture(m_texture, NULL, NULL, &tileWidth, &tileHeight);
+    SDL_QueryTexture(texture, NULL, NULL, &tileWidth, &tileHeight);
 
     // Get the position and width of the entire ground segment in pixels
     b2Vec2 segmentPos = b2Body_GetPosition(Body_Id);
@@ -398,7 +437,7 @@ void Scenery::Render(SDL_Renderer* renderer, float cameraX)
                 tileHeight
         };
 
-        SDL_RenderCopy(renderer, m_texture, NULL, &destRect);
+        SDL_RenderCopy(renderer, texture, NULL, &destRect);
     }
 }
 
@@ -416,9 +455,23 @@ float Scenery::Get_Right_EdgeX() const
     return (pos.x + m_Width_Meters / 2.0f) * PIXELS_PER_METER;
 }
 
+void Scenery::Respawn(float startX, Texture_Handle texture)
+{
+    m_texture = texture;
+
+    const float Ground_Height_Px = 20.0f;
+    Activate({ startX / PIXELS_PER_METER + m_Width_Meters / 2.0f, (SCREEN_HEIGHT - (Ground_Height_Px / 2.0f)) / PIXELS_PER_METER });
+}
+
+float Scenery::Get_Left_EdgeX() const
+{
+    b2Vec2 pos = b2Body_GetPosition(Body_Id);
+    return (pos.x - m_Width_Meters / 2.0f) * PIXELS_PER_METER;
+}
+
 // Obstacles
 
-Obstacle::Obstacle(b2WorldId worldId, float x, float y, float width, float height, SDL_Texture* texture)
+Obstacle::Obstacle(b2WorldId worldId, float x, float y, float width, float height, Texture_Handle texture)
 {
     m_texture = texture;
     // Store the obstacle's size in pixels
@@ -455,16 +508,38 @@ Obstacle::Obstacle(b2WorldId worldId, float x, float y, float width, float heigh
 
     // --- 3. Create the Shape in the World ---
     // Create the shape and get its ID
-    b2ShapeId shape_ID = b2CreatePolygonShape(Body_Id, &shapeDef, &box);
+    m_shapeId = b2CreatePolygonShape(Body_Id, &shapeDef, &box);
 
     // Set the final material properties
-    b2Shape_SetRestitution(shape_ID, 0.0f); // No bounce
-    b2Shape_SetFriction(shape_ID, 0.5f);
+    b2Shape_SetRestitution(m_shapeId, 0.0f); // No bounce
+    b2Shape_SetFriction(m_shapeId, 0.5f);
+}
+
+void Obstacle::Respawn(float x, float y, float width, float height, Texture_Handle texture)
+{
+    m_texture = texture;
+    m_isScored = false;
+
+    // Only resize the box when the pooled obstacle had a different shape
+    if (width != m_Width_Px || height != m_Height_Px)
+    {
+        m_Width_Px = width;
+        m_Height_Px = height;
+
+        b2Polygon box = b2MakeBox(
+                (m_Width_Px / 2.0f) / PIXELS_PER_METER,
+                (m_Height_Px / 2.0f) / PIXELS_PER_METER
+        );
+        b2Shape_SetPolygon(m_shapeId, &box);
+    }
+
+    Activate({ x / PIXELS_PER_METER, y / PIXELS_PER_METER });
 }
 
 void Obstacle::Render(SDL_Renderer* renderer, float cameraX)
 {
-    if (m_texture == nullptr) return;
+    SDL_Texture* texture = Asset_Manager::GetInstance().GetTexture(m_texture);
+    if (texture == nullptr) return;
 
     const float visual_Y_Offset = 20.0f;
 
@@ -478,7 +553,7 @@ void Obstacle::Render(SDL_Renderer* renderer, float cameraX)
 
 //    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
 //    SDL_RenderFillRect(renderer, &rect);
-    SDL_RenderCopy(renderer, m_texture, NULL, &rect);
+    SDL_RenderCopy(renderer, texture, NULL, &rect);
 
 }
 
@@ -524,33 +599,33 @@ PowerUp::PowerUp(b2WorldId worldId, PowerUpType type, float x, float y) : m_type
     switch (m_type)
     {
         case PowerUpType::EXTRA_JUMP:
-            m_texture = Asset_Manager::GetInstance().GetTexture("powerUp");
+            m_texture = Asset_Manager::GetInstance().GetHandle("powerUp");
             break;
         case PowerUpType::DOUBLE_SCORE:
-            m_texture = Asset_Manager::GetInstance().GetTexture("powerUp");
+            m_texture = Asset_Manager::GetInstance().GetHandle("powerUp");
             break;
     }
 
-    m_frameCount = 10; // Both sprite sheets have 10 main animation frames
-    m_animSpeed = 0.1f; // Adjust for desired rotation speed
-    m_currentFrame = 0;
-    m_animTimer = 0.0f;
+    m_animPhase = Animation_Clock::GetInstance().Start_Phase(Get_Clip(Clip_Id::POWER_UP_SPIN));
+}
 
-    if (m_texture)
-    {
-        int textureWidth, textureHeight;
-        SDL_QueryTexture(m_texture, NULL, NULL, &textureWidth, &textureHeight);
-        m_frameWidth = textureWidth / 10;
-        m_frameHeight = textureHeight;
-    }
+void PowerUp::Respawn(PowerUpType type, float x, float y)
+{
+    // Both types share one sprite sheet, so only the type and animation need resetting
+    m_type = type;
+    m_animPhase = Animation_Clock::GetInstance().Start_Phase(Get_Clip(Clip_Id::POWER_UP_SPIN));
+
+    Activate({ x, y });
 }
 
 void PowerUp::Render(SDL_Renderer* renderer, float cameraX)
 {
-    if (m_texture == nullptr) return;
+    SDL_Texture* texture = Asset_Manager::GetInstance().GetTexture(m_texture);
+    if (texture == nullptr) return;
 
     // Source rect on the sprite sheet
-    SDL_Rect srcRect = { m_currentFrame * m_frameWidth, 0, m_frameWidth, m_frameHeight };
+    const Animation_Clip& clip = Get_Clip(Clip_Id::POWER_UP_SPIN);
+    SDL_Rect srcRect = clip.Source_Rect(texture, Animation_Clock::GetInstance().Frame(clip, m_animPhase));
 
     // Destination rect on the screen
     b2Vec2 position = b2Body_GetPosition(Body_Id);
@@ -562,18 +637,12 @@ void PowerUp::Render(SDL_Renderer* renderer, float cameraX)
             radius * 2
     };
 
-    SDL_RenderCopy(renderer, m_texture, &srcRect, &destRect);
+    SDL_RenderCopy(renderer, texture, &srcRect, &destRect);
 }
 
 void PowerUp::Update(b2WorldId worldId, float deltaTime, int score)
 {
-    // This animation timer logic is the same as the Player's
-    m_animTimer += deltaTime;
-    if (m_animTimer >= m_animSpeed)
-    {
-        m_currentFrame = (m_currentFrame + 1) % m_frameCount;
-        m_animTimer -= m_animSpeed;
-    }
+    // Nothing to do: the spin is read off the Animation_Clock at draw time
 }
 
 // Health
@@ -599,28 +668,19 @@ Health::Health(b2WorldId worldId, PowerUpType type, float x, float y)
     circle.radius = 20.0f / PIXELS_PER_METER; // All power-ups are 20px radius circles
     b2CreateCircleShape(Body_Id, &shapeDef, &circle);
 
-    m_texture = Asset_Manager::GetInstance().GetTexture("health");
-
-    m_frameCount = 10; // Both sprite sheets have 10 main animation frames
-    m_animSpeed = 0.1f; // Adjust for desired rotation speed
-    m_currentFrame = 0;
-    m_animTimer = 0.0f;
+    m_texture = Asset_Manager::GetInstance().GetHandle("health");
 
-    if (m_texture)
-    {
-        int textureWidth, textureHeight;
-        SDL_QueryTexture(m_texture, NULL, NULL, &textureWidth, &textureHeight);
-        m_frameWidth = textureWidth / 10;
-        m_frameHeight = textureHeight;
-    }
+    m_animPhase = Animation_Clock::GetInstance().Start_Phase(Get_Clip(Clip_Id::HEALTH_SPIN));
 }
 
 void Health::Render(SDL_Renderer* renderer, float cameraX)
 {
-    if (m_texture == nullptr) return;
+    SDL_Texture* texture = Asset_Manager::GetInstance().GetTexture(m_texture);
+    if (texture == nullptr) return;
 
     // Source rect on the sprite sheet
-    SDL_Rect srcRect = { m_currentFrame * m_frameWidth, 0, m_frameWidth, m_frameHeight };
+    const Animation_Clip& clip = Get_Clip(Clip_Id::HEALTH_SPIN);
+    SDL_Rect srcRect = clip.Source_Rect(texture, Animation_Clock::GetInstance().Frame(clip, m_animPhase));
 
     // Destination rect on the screen
     b2Vec2 position = b2Body_GetPosition(Body_Id);
@@ -632,18 +692,12 @@ void Health::Render(SDL_Renderer* renderer, float cameraX)
             radius * 2
     };
 
-    SDL_RenderCopy(renderer, m_texture, &srcRect, &destRect);
+    SDL_RenderCopy(renderer, texture, &srcRect, &destRect);
 }
 
 void Health::Update(b2WorldId worldId, float deltaTime, int score)
 {
-    // This animation timer logic is the same as the Player's
-    m_animTimer += deltaTime;
-    if (m_animTimer >= m_animSpeed)
-    {
-        m_currentFrame = (m_currentFrame + 1) % m_frameCount;
-        m_animTimer -= m_animSpeed;
-    }
+    // Nothing to do: the spin is read off the Animation_Clock at draw time
 }
 
 // Coins
@@ -669,28 +723,26 @@ Coin::Coin(b2WorldId worldId, float x, float y)
     circle.radius = 20.0f / PIXELS_PER_METER; // All power-ups are 20px radius circles
     b2CreateCircleShape(Body_Id, &shapeDef, &circle);
 
-    m_texture = Asset_Manager::GetInstance().GetTexture("Coin");
+    m_texture = Asset_Manager::GetInstance().GetHandle("Coin");
 
-    m_frameCount = 10; // Both sprite sheets have 10 main animation frames
-    m_animSpeed = 0.1f; // Adjust for desired rotation speed
-    m_currentFrame = 0;
-    m_animTimer = 0.0f;
+    m_animPhase = Animation_Clock::GetInstance().Start_Phase(Get_Clip(Clip_Id::COIN_SPIN));
+}
 
-    if (m_texture)
-    {
-        int textureWidth, textureHeight;
-        SDL_QueryTexture(m_texture, NULL, NULL, &textureWidth, &textureHeight);
-        m_frameWidth = textureWidth / 10;
-        m_frameHeight = textureHeight;
-    }
+void Coin::Respawn(float x, float y)
+{
+    m_animPhase = Animation_Clock::GetInstance().Start_Phase(Get_Clip(Clip_Id::COIN_SPIN));
+
+    Activate({ x, y });
 }
 
 void Coin::Render(SDL_Renderer* renderer, float cameraX)
 {
-    if (m_texture == nullptr) return;
+    SDL_Texture* texture = Asset_Manager::GetInstance().GetTexture(m_texture);
+    if (texture == nullptr) return;
 
     // Source rect on the sprite sheet
-    SDL_Rect srcRect = { m_currentFrame * m_frameWidth, 0, m_frameWidth, m_frameHeight };
+    const Animation_Clip& clip = Get_Clip(Clip_Id::COIN_SPIN);
+    SDL_Rect srcRect = clip.Source_Rect(texture, Animation_Clock::GetInstance().Frame(clip, m_animPhase));
 
     // Destination rect on the screen
     b2Vec2 position = b2Body_GetPosition(Body_Id);
@@ -702,16 +754,10 @@ void Coin::Render(SDL_Renderer* renderer, float cameraX)
             radius * 2
     };
 
-    SDL_RenderCopy(renderer, m_texture, &srcRect, &destRect);
+    SDL_RenderCopy(renderer, texture, &srcRect, &destRect);
 }
 
 void Coin::Update(b2WorldId worldId, float deltaTime, int score)
 {
-    // This animation timer logic is the same as the Player's
-    m_animTimer += deltaTime;
-    if (m_animTimer >= m_animSpeed)
-    {
-        m_currentFrame = (m_currentFrame + 1) % m_frameCount;
-        m_animTimer -= m_animSpeed;
-    }
+    // Nothing to do: the spin is read off the Animation_Clock at draw time
 }
\ No newline at end of file
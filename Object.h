@@ -7,6 +7,7 @@
 
 #include "Audio_Manager.h"
 #include "Asset_Manager.h"
+#include "Animation.h"
 
 // Global Variables
 
@@ -20,6 +21,22 @@ const uint16_t OBSTACLE_CATEGORY = 0x0004;
 
 enum class PowerUpType { EXTRA_JUMP, DOUBLE_SCORE };
 
+// Everything needed to put the player back exactly where a snapshot left it
+struct Player_State
+{
+    b2Vec2 position;
+    b2Vec2 velocity;
+    bool isDead;
+    int jumpsLeft;
+    float airSeconds;
+    bool groundJumpUsed;
+    float doubleScoreTimer;
+    float extraJumpTimer;
+    float speed;
+    int animState;
+    float animPhase;
+};
+
 // Classes
 
 class Object
@@ -27,12 +44,21 @@ class Object
 protected:
     b2BodyId Body_Id  = b2_nullBodyId;
     const float PIXELS_PER_METER = 30.0f;
-    SDL_Texture* m_texture;
+    Texture_Handle m_texture;   // Resolved at draw time, so reloaded or evicted textures are picked up
     string m_currentSkin = "";
 public:
     virtual ~Object();
     virtual void Update(b2WorldId worldId, float deltaTime, int score) = 0;
     virtual void Render(SDL_Renderer* renderer, float cameraX) = 0;
+
+    Texture_Handle Get_Texture() const { return m_texture; }
+
+    // Pooled objects keep their body between uses, disabled while parked
+    void Activate(b2Vec2 position);
+    void Deactivate();
+
+    // Moves the body by -offset, keeping its velocity (used when the world origin is rebased)
+    void Shift_Origin(b2Vec2 offset);
 };
 
 // Player
@@ -46,20 +72,22 @@ private:
     float m_doubleScoreTimer = 0.0f;
     float m_extraJumpTimer = 0.0f;
 
+    // Coyote time: walking off a ledge keeps the ground jump for a moment, then it's gone
+    float m_coyoteSeconds = 0.08f;
+    float m_airSeconds = 0.0f;          // Since last standing on the ground
+    bool m_groundJumpUsed = false;      // Jumped, or the coyote time ran out, since then
+
     float PLAYER_SPEED = 20.0f;
     const float BASE_SPEED = 20.0f;
     const float MAX_SPEED = 100.0f;
 
+    Sound_Handle m_jumpSound;
+
     // Animations
     enum class AnimationState { RUNNING, JUMPING, FALLING };
-    AnimationState m_animState;
-    int m_animRow;
-    int m_frameCount;      // Total number of frames in the animation
-    int m_currentFrame;    // The current frame to draw (e.g., 0, 1, 2...)
-    int m_frameWidth;      // The width of a single frame in the sprite sheet
-    int m_frameHeight;     // The height of a single frame
-    float m_animTimer;       // Timer to control animation speed
-    float m_animSpeed;       // How long each frame is displayed (in seconds)
+    AnimationState m_animState = AnimationState::RUNNING;
+    Clip_Id m_clip = Clip_Id::PLAYER_RUN;
+    float m_animPhase = 0.0f;   // Against the Animation_Clock
     void SetAnimation(AnimationState state);
 
 public:
@@ -80,9 +108,13 @@ public:
 
     bool Is_On_Ground(b2WorldId worldId);
     bool Can_Jump() const;
+    void Set_Coyote_Time(float seconds) { m_coyoteSeconds = seconds; }
 
     void Reset();
 
+    Player_State Get_State() const;
+    void Set_State(const Player_State& state);
+
     void ActivatePowerUp(PowerUpType type);
     bool HasExtraJump() { return m_extraJumpTimer > 0.0f; }
     bool HasDoubleScore() { return m_doubleScoreTimer > 0.0f; }
@@ -99,28 +131,36 @@ class Scenery : public Object
 private:
     float m_Width_Meters;
 public:
-    explicit Scenery(b2WorldId WID, float startX, SDL_Texture* texture);
+    explicit Scenery(b2WorldId WID, float startX, Texture_Handle texture);
     ~Scenery();
 
     void Update(b2WorldId worldId, float deltaTime, int score) override;
     void Render(SDL_Renderer* renderer, float cameraX) override;
     float Get_Right_EdgeX() const;
+    float Get_Left_EdgeX() const;
+    void Respawn(float startX, Texture_Handle texture);
 };
 
 // Obstacles
 
+enum class Obstacle_Kind : uint8_t { SMALL, TALL, WIDE };
+
 class Obstacle : public Object
 {
 private:
     float m_Width_Px;
     float m_Height_Px;
+    b2ShapeId m_shapeId;
 
     bool m_isScored = false;
+    Obstacle_Kind m_kind = Obstacle_Kind::SMALL;
 public:
-    explicit Obstacle(b2WorldId worldId, float x, float y, float width, float height, SDL_Texture* texture);
+    explicit Obstacle(b2WorldId worldId, float x, float y, float width, float height, Texture_Handle texture);
 
     ~Obstacle();
 
+    void Respawn(float x, float y, float width, float height, Texture_Handle texture);
+
     void Update(b2WorldId worldId, float deltaTime, int score) override;
     void Render(SDL_Renderer* renderer, float cameraX) override;
     float Get_Right_EdgeX() const;
@@ -131,6 +171,9 @@ public:
 
     bool Is_Scored() const { return m_isScored; }
     void Set_Scored(bool scored) { m_isScored = scored; }
+
+    Obstacle_Kind Get_Kind() const { return m_kind; }
+    void Set_Kind(Obstacle_Kind kind) { m_kind = kind; }
 };
 
 // Power Ups
@@ -139,15 +182,10 @@ class PowerUp : public Object
 {
 private:
     PowerUpType m_type;
-
-    int m_frameCount;
-    int m_currentFrame;
-    int m_frameWidth;
-    int m_frameHeight;
-    float m_animTimer;
-    float m_animSpeed;
+    float m_animPhase = 0.0f;   // Spins from the first frame when spawned
 public:
     explicit PowerUp(b2WorldId worldId, PowerUpType type, float x, float y);
+    void Respawn(PowerUpType type, float x, float y);
     void Render(SDL_Renderer* renderer, float cameraX) override;
     void Update(b2WorldId worldId, float deltaTime, int score) override;
 
@@ -161,12 +199,7 @@ public:
 class Health : public Object
 {
 private:
-    int m_frameCount;
-    int m_currentFrame;
-    int m_frameWidth;
-    int m_frameHeight;
-    float m_animTimer;
-    float m_animSpeed;
+    float m_animPhase = 0.0f;
 public:
     explicit Health(b2WorldId worldId, PowerUpType type, float x, float y);
     void Render(SDL_Renderer* renderer, float cameraX) override;
@@ -181,14 +214,10 @@ public:
 class Coin : public Object
 {
 private:
-    int m_frameCount;
-    int m_currentFrame;
-    int m_frameWidth;
-    int m_frameHeight;
-    float m_animTimer;
-    float m_animSpeed;
+    float m_animPhase = 0.0f;
 public:
     explicit Coin(b2WorldId worldId, float x, float y);
+    void Respawn(float x, float y);
     void Render(SDL_Renderer* renderer, float cameraX) override;
     void Update(b2WorldId worldId, float deltaTime, int score) override;
 
@@ -0,0 +1,211 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Particle_System.h"
+#include <algorithm>
+#include <cmath>
+
+float Particle_System::Random(float low, float high)
+{
+    // xorshift32
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 17;
+    m_rng ^= m_rng << 5;
+    return low + (high - low) * static_cast<float>(m_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+int Particle_System::Add_Pool(Texture_Handle texture, int capacity)
+{
+    Pool pool;
+    pool.texture = texture;
+    pool.capacity = capacity;
+    pool.x.resize(capacity);
+    pool.y.resize(capacity);
+    pool.vx.resize(capacity);
+    pool.vy.resize(capacity);
+    pool.gravity.resize(capacity);
+    pool.age.resize(capacity);
+    pool.ageRate.resize(capacity);
+    pool.size.resize(capacity);
+    pool.color.resize(capacity);
+    pool.vertices.resize(static_cast<size_t>(capacity) * 4);
+
+    // The texture coordinates never change, so they're written once here
+    for (int i = 0; i < capacity; ++i)
+    {
+        SDL_Vertex* quad = &pool.vertices[static_cast<size_t>(i) * 4];
+        quad[0].tex_coord = { 0.0f, 0.0f };
+        quad[1].tex_coord = { 1.0f, 0.0f };
+        quad[2].tex_coord = { 1.0f, 1.0f };
+        quad[3].tex_coord = { 0.0f, 1.0f };
+    }
+
+    size_t quads = m_indices.size() / 6;
+    for (size_t i = quads; i < static_cast<size_t>(capacity); ++i)
+    {
+        int first = static_cast<int>(i * 4);
+        for (int offset : { 0, 1, 2, 0, 2, 3 })
+        {
+            m_indices.push_back(first + offset);
+        }
+    }
+
+    m_pools.push_back(move(pool));
+    return static_cast<int>(m_pools.size()) - 1;
+}
+
+void Particle_System::Emit(int poolIndex, float x, float y, const Particle_Burst& burst)
+{
+    Pool& pool = m_pools[poolIndex];
+    int count = min(burst.count, pool.capacity - pool.count);
+
+    for (int n = 0; n < count; ++n)
+    {
+        int i = pool.count++;
+        float angle = burst.angle + Random(-burst.spread, burst.spread);
+        float speed = Random(burst.speedMin, burst.speedMax);
+
+        pool.x[i] = x;
+        pool.y[i] = y;
+        pool.vx[i] = cosf(angle) * speed;
+        pool.vy[i] = sinf(angle) * speed;
+        pool.gravity[i] = burst.gravity;
+        pool.age[i] = 0.0f;
+        pool.ageRate[i] = 1.0f / Random(burst.lifeMin, burst.lifeMax);
+        pool.size[i] = Random(burst.sizeMin, burst.sizeMax);
+        pool.color[i] = burst.color;
+    }
+}
+
+void Particle_System::Update(float deltaTime)
+{
+    for (Pool& pool : m_pools)
+    {
+        const int count = pool.count;
+        float* x = pool.x.data();
+        float* y = pool.y.data();
+        float* vx = pool.vx.data();
+        float* vy = pool.vy.data();
+        const float* gravity = pool.gravity.data();
+        float* age = pool.age.data();
+        const float* ageRate = pool.ageRate.data();
+
+        // Branch-free so these vectorize
+        for (int i = 0; i < count; ++i)
+        {
+            vy[i] += gravity[i] * deltaTime;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            x[i] += vx[i] * deltaTime;
+            y[i] += vy[i] * deltaTime;
+            age[i] += ageRate[i] * deltaTime;
+        }
+
+        // Swap dead particles with the last live one; draw order doesn't matter with additive blending
+        int live = count;
+        for (int i = 0; i < live; )
+        {
+            if (age[i] < 1.0f)
+            {
+                ++i;
+                continue;
+            }
+
+            --live;
+            x[i] = x[live];
+            y[i] = y[live];
+            vx[i] = vx[live];
+            vy[i] = vy[live];
+            pool.gravity[i] = gravity[live];
+            age[i] = age[live];
+            pool.ageRate[i] = ageRate[live];
+            pool.size[i] = pool.size[live];
+            pool.color[i] = pool.color[live];
+        }
+        pool.count = live;
+    }
+}
+
+void Particle_System::Render(SDL_Renderer* renderer, float cameraX)
+{
+    for (Pool& pool : m_pools)
+    {
+        if (pool.count == 0) continue;
+
+        SDL_Texture* texture = nullptr;
+        if (pool.texture.IsValid())
+        {
+            texture = Asset_Manager::GetInstance().GetTexture(pool.texture);
+            if (texture == nullptr) continue;
+        }
+
+        SDL_Vertex* vertices = pool.vertices.data();
+        for (int i = 0; i < pool.count; ++i)
+        {
+            float life = 1.0f - pool.age[i];
+            float half = pool.size[i] * (0.5f + 0.5f * life) * 0.5f;
+            float left = pool.x[i] - cameraX - half;
+            float right = pool.x[i] - cameraX + half;
+            float top = pool.y[i] - half;
+            float bottom = pool.y[i] + half;
+
+            SDL_Color color = pool.color[i];
+            color.a = static_cast<Uint8>(color.a * life);
+
+            SDL_Vertex* quad = vertices + i * 4;
+            quad[0].position = { left, top };
+            quad[1].position = { right, top };
+            quad[2].position = { right, bottom };
+            quad[3].position = { left, bottom };
+            quad[0].color = quad[1].color = quad[2].color = quad[3].color = color;
+        }
+
+        // One draw for the whole pool, blended additively. Untextured quads take the draw blend
+        // mode and textured ones the texture's; the texture may be shared with sprites, so it's put back.
+        SDL_BlendMode previousDraw, previousTexture = SDL_BLENDMODE_BLEND;
+        SDL_GetRenderDrawBlendMode(renderer, &previousDraw);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_ADD);
+        if (texture)
+        {
+            SDL_GetTextureBlendMode(texture, &previousTexture);
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_ADD);
+        }
+
+        SDL_RenderGeometry(renderer, texture, vertices, pool.count * 4, m_indices.data(), pool.count * 6);
+
+        SDL_SetRenderDrawBlendMode(renderer, previousDraw);
+        if (texture) SDL_SetTextureBlendMode(texture, previousTexture);
+    }
+}
+
+void Particle_System::Shift_Origin(float shiftPx)
+{
+    for (Pool& pool : m_pools)
+    {
+        float* x = pool.x.data();
+        for (int i = 0; i < pool.count; ++i)
+        {
+            x[i] -= shiftPx;
+        }
+    }
+}
+
+void Particle_System::Clear()
+{
+    for (Pool& pool : m_pools)
+    {
+        pool.count = 0;
+    }
+}
+
+int Particle_System::Live_Count() const
+{
+    int count = 0;
+    for (const Pool& pool : m_pools)
+    {
+        count += pool.count;
+    }
+    return count;
+}
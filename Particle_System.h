@@ -0,0 +1,71 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_PARTICLE_SYSTEM_H
+#define ENDLESS_RUNNER_PARTICLE_SYSTEM_H
+
+#include "Asset_Manager.h"
+#include <SDL2/SDL.h>
+#include <vector>
+
+using namespace std;
+
+// One emission: count particles fired from a point into a cone
+struct Particle_Burst
+{
+    int count;
+    float speedMin, speedMax;   // Pixels per second
+    float angle, spread;        // Cone direction and half-width, in radians. Screen y is down, so -PI/2 is up.
+    float lifeMin, lifeMax;     // Seconds
+    float sizeMin, sizeMax;     // Pixels, shrinking to half by the end of the life
+    float gravity;              // Pixels per second squared, down
+    SDL_Color color;            // Alpha fades to 0 over the life
+};
+
+// Cosmetic particles, in world pixels. Each pool is a fixed-capacity structure of arrays, so the
+// integration is a few straight loops over floats the compiler vectorizes, and a pool draws with
+// one SDL_RenderGeometry call for its texture. Nothing allocates after Add_Pool; emitting into a
+// full pool drops the extra particles.
+class Particle_System
+{
+private:
+    struct Pool
+    {
+        Texture_Handle texture;     // Invalid for untextured quads
+        int capacity = 0;
+        int count = 0;
+
+        vector<float> x, y;
+        vector<float> vx, vy;
+        vector<float> gravity;
+        vector<float> age;          // 0 at birth, 1 at death
+        vector<float> ageRate;      // 1 / life
+        vector<float> size;
+        vector<SDL_Color> color;
+
+        vector<SDL_Vertex> vertices; // Four per particle, rebuilt every draw
+    };
+
+    vector<Pool> m_pools;
+    vector<int> m_indices;          // Two triangles per quad, shared by every pool
+    uint32_t m_rng = 0x9E3779B9u;   // Its own generator, so effects never shift the run's rand() sequence
+
+    float Random(float low, float high);
+public:
+    // Returns the pool's index for Emit. Call before play starts; this is the only allocation.
+    int Add_Pool(Texture_Handle texture, int capacity);
+
+    void Emit(int pool, float x, float y, const Particle_Burst& burst);
+    void Update(float deltaTime);
+    void Render(SDL_Renderer* renderer, float cameraX);
+
+    // Floating-origin rebase, in pixels
+    void Shift_Origin(float shiftPx);
+    void Clear();
+
+    int Live_Count() const;
+};
+
+
+#endif //ENDLESS_RUNNER_PARTICLE_SYSTEM_H
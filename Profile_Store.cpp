@@ -0,0 +1,154 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Profile_Store.h"
+#include "Mapped_File.h"
+#include "Rewind_Buffer.h"
+#include <array>
+#include <fstream>
+
+namespace
+{
+    const uint32_t PROFILE_MAGIC = 0x46505245; // "ERPF"
+
+    struct Profile_Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t payloadSize;
+        uint32_t crc;
+    };
+
+    uint32_t Crc32(const uint8_t* data, size_t size)
+    {
+        static const array<uint32_t, 256> table = []
+        {
+            array<uint32_t, 256> entries;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+                }
+                entries[i] = value;
+            }
+            return entries;
+        }();
+
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    void Write_String(Snapshot_Writer& writer, const string& value)
+    {
+        writer.Write(static_cast<uint32_t>(value.size()));
+        for (char c : value) writer.Write(c);
+    }
+
+    bool Read_String(Snapshot_Reader& reader, string& value)
+    {
+        uint32_t length;
+        if (!reader.Read(length) || length > 1024) return false;
+
+        value.resize(length);
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            if (!reader.Read(value[i])) return false;
+        }
+        return true;
+    }
+}
+
+void Profile_Store::Encode(const Profile& profile, vector<uint8_t>& out)
+{
+    Snapshot_Writer writer(out);
+    writer.Write(Profile_Header{});
+
+    writer.Write(static_cast<uint32_t>(profile.highScores.size()));
+    for (int score : profile.highScores) writer.Write(static_cast<int32_t>(score));
+
+    writer.Write(static_cast<int64_t>(profile.totalCoins));
+    Write_String(writer, profile.equippedSkin);
+
+    writer.Write(static_cast<uint32_t>(profile.unlockedSkins.size()));
+    for (const string& skin : profile.unlockedSkins) Write_String(writer, skin);
+
+    Profile_Header header = { PROFILE_MAGIC, VERSION, static_cast<uint32_t>(out.size() - sizeof(Profile_Header)), 0 };
+    header.crc = Crc32(out.data() + sizeof(Profile_Header), header.payloadSize);
+    memcpy(out.data(), &header, sizeof(header));
+}
+
+bool Profile_Store::Load(const string& path, Profile& out)
+{
+    Mapped_File file;
+    if (!file.Open(path) || file.Size() < sizeof(Profile_Header)) return false;
+
+    Profile_Header header;
+    memcpy(&header, file.Data(), sizeof(header));
+    if (header.magic != PROFILE_MAGIC || header.version > VERSION) return false;
+    if (header.payloadSize > file.Size() - sizeof(Profile_Header)) return false;
+
+    const uint8_t* payload = file.Data() + sizeof(Profile_Header);
+    if (Crc32(payload, header.payloadSize) != header.crc) return false;
+
+    Profile profile;
+    Snapshot_Reader reader(payload, header.payloadSize);
+
+    uint32_t scoreCount;
+    if (!reader.Read(scoreCount) || scoreCount > 1000) return false;
+    for (uint32_t i = 0; i < scoreCount; ++i)
+    {
+        int32_t score;
+        if (!reader.Read(score)) return false;
+        profile.highScores.push_back(score);
+    }
+
+    int64_t totalCoins;
+    if (!reader.Read(totalCoins)) return false;
+    profile.totalCoins = static_cast<long int>(totalCoins);
+
+    if (!Read_String(reader, profile.equippedSkin)) return false;
+
+    uint32_t skinCount;
+    if (!reader.Read(skinCount) || skinCount > 1000) return false;
+    for (uint32_t i = 0; i < skinCount; ++i)
+    {
+        string skin;
+        if (!Read_String(reader, skin)) return false;
+        profile.unlockedSkins.push_back(skin);
+    }
+
+    out = profile;
+    return true;
+}
+
+bool Profile_Store::Import_Legacy(const string& scoresPath, const string& walletPath, Profile& out)
+{
+    bool found = false;
+
+    ifstream scoreFile(scoresPath);
+    if (scoreFile.is_open())
+    {
+        out.highScores.clear();
+        int score;
+        while (scoreFile >> score)
+        {
+            out.highScores.push_back(score);
+        }
+        found = true;
+    }
+
+    ifstream walletFile(walletPath);
+    if (walletFile.is_open())
+    {
+        walletFile >> out.totalCoins;
+        found = true;
+    }
+    return found;
+}
@@ -0,0 +1,40 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_PROFILE_STORE_H
+#define ENDLESS_RUNNER_PROFILE_STORE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Everything about the player that outlives a session
+struct Profile
+{
+    vector<int> highScores;
+    long int totalCoins = 0;
+    string equippedSkin = "player_default";
+    vector<string> unlockedSkins;
+};
+
+// Versioned, checksummed binary encoding of the profile:
+// header { magic "ERPF", version, payload size, CRC-32 of payload } followed by the payload.
+class Profile_Store
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    static void Encode(const Profile& profile, vector<uint8_t>& out);
+
+    // Maps the file and decodes it. False if it's missing, truncated, from a newer version or fails its checksum.
+    static bool Load(const string& path, Profile& out);
+
+    // Reads the old scores.txt / wallet.txt files. False if neither exists.
+    static bool Import_Legacy(const string& scoresPath, const string& walletPath, Profile& out);
+};
+
+
+#endif //ENDLESS_RUNNER_PROFILE_STORE_H
@@ -0,0 +1,224 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Rewind_Buffer.h"
+#include <algorithm>
+
+// helper
+
+static void Write_VarInt(vector<uint8_t>& out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool Read_VarInt(const vector<uint8_t>& in, size_t& offset, uint32_t& value)
+{
+    value = 0;
+    int shift = 0;
+    while (offset < in.size() && shift < 32)
+    {
+        uint8_t byte = in[offset++];
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+        shift += 7;
+    }
+    return false;
+}
+
+// Rewind_Buffer
+
+Rewind_Buffer::Rewind_Buffer(int capacityFrames, int keyframeInterval)
+    : m_slots(capacityFrames > 0 ? capacityFrames : 1), m_keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1)
+{
+}
+
+void Rewind_Buffer::Push(uint32_t frame, const vector<uint8_t>& state)
+{
+    Slot& slot = m_slots[m_head];
+    m_storedBytes -= slot.data.size();
+
+    // A new keyframe every interval, or whenever there is nothing to diff against
+    slot.isKeyframe = (m_count == 0) || (frame % m_keyframeInterval == 0);
+    slot.frame = frame;
+    slot.isUsed = true;
+
+    // assign() and the encoder reuse the slot's capacity, so the ring stops allocating once warm
+    if (slot.isKeyframe)
+    {
+        slot.data.assign(state.begin(), state.end());
+    }
+    else
+    {
+        Encode_Delta(m_previous, state, slot.data);
+    }
+    m_storedBytes += slot.data.size();
+
+    m_previous.assign(state.begin(), state.end());
+
+    m_head = (m_head + 1) % static_cast<int>(m_slots.size());
+    if (m_count < static_cast<int>(m_slots.size())) m_count++;
+}
+
+int Rewind_Buffer::Find_Slot(uint32_t frame) const
+{
+    for (int i = 0; i < m_count; ++i)
+    {
+        int index = (m_head - 1 - i + static_cast<int>(m_slots.size())) % static_cast<int>(m_slots.size());
+        if (m_slots[index].frame == frame) return i;
+    }
+    return -1;
+}
+
+bool Rewind_Buffer::Restore(uint32_t frame, vector<uint8_t>& out) const
+{
+    int age = Find_Slot(frame); // 0 = newest
+    if (age < 0) return false;
+
+    const int size = static_cast<int>(m_slots.size());
+
+    // Walk back to the keyframe this frame's delta chain starts from
+    int keyAge = age;
+    while (keyAge < m_count && !m_slots[(m_head - 1 - keyAge + size) % size].isKeyframe)
+    {
+        keyAge++;
+    }
+    if (keyAge >= m_count) return false; // The keyframe was already overwritten
+
+    out = m_slots[(m_head - 1 - keyAge + size) % size].data;
+
+    // Replay the deltas forward up to the requested frame
+    vector<uint8_t> next;
+    for (int i = keyAge - 1; i >= age; --i)
+    {
+        const Slot& slot = m_slots[(m_head - 1 - i + size) % size];
+        if (!Apply_Delta(out, slot.data, next)) return false;
+        out.swap(next);
+    }
+    return true;
+}
+
+bool Rewind_Buffer::Truncate_After(uint32_t frame, const vector<uint8_t>& state)
+{
+    int newer = Find_Slot(frame);
+    if (newer < 0) return false;
+
+    const int size = static_cast<int>(m_slots.size());
+    for (int age = newer; age > 0; --age)
+    {
+        m_head = (m_head - 1 + size) % size;
+        Slot& slot = m_slots[m_head];
+        m_storedBytes -= slot.data.size();
+        slot.data.clear();
+        slot.isUsed = false;
+        m_count--;
+    }
+    m_previous.assign(state.begin(), state.end());
+    return true;
+}
+
+bool Rewind_Buffer::Oldest_Restorable(uint32_t& frame) const
+{
+    const int size = static_cast<int>(m_slots.size());
+    for (int age = m_count - 1; age >= 0; --age)
+    {
+        const Slot& slot = m_slots[(m_head - 1 - age + size) % size];
+        if (slot.isKeyframe)
+        {
+            frame = slot.frame;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Rewind_Buffer::Newest(uint32_t& frame) const
+{
+    if (m_count == 0) return false;
+    const int size = static_cast<int>(m_slots.size());
+    frame = m_slots[(m_head - 1 + size) % size].frame;
+    return true;
+}
+
+void Rewind_Buffer::Clear()
+{
+    for (auto& slot : m_slots)
+    {
+        slot.isUsed = false;
+        slot.data.clear();
+    }
+    m_previous.clear();
+    m_head = 0;
+    m_count = 0;
+    m_storedBytes = 0;
+}
+
+// Delta format: target size, then pairs of (unchanged run, literal run + bytes).
+// Most of the world barely moves between two frames, so the unchanged runs dominate.
+
+void Rewind_Buffer::Encode_Delta(const vector<uint8_t>& base, const vector<uint8_t>& target, vector<uint8_t>& out)
+{
+    out.clear();
+    Write_VarInt(out, static_cast<uint32_t>(target.size()));
+
+    const size_t MIN_MATCH = 4; // Shorter matches cost more to encode than the bytes themselves
+    size_t i = 0;
+    while (i < target.size())
+    {
+        size_t same = 0;
+        while (i + same < target.size() && i + same < base.size() && base[i + same] == target[i + same])
+        {
+            same++;
+        }
+
+        size_t literalStart = i + same;
+        size_t literalEnd = literalStart;
+        while (literalEnd < target.size())
+        {
+            // Stop the literal once a long enough unchanged run begins
+            size_t run = 0;
+            while (run < MIN_MATCH && literalEnd + run < target.size() && literalEnd + run < base.size()
+                   && base[literalEnd + run] == target[literalEnd + run])
+            {
+                run++;
+            }
+            if (run == MIN_MATCH) break;
+            literalEnd += (run > 0) ? run : 1;
+        }
+
+        Write_VarInt(out, static_cast<uint32_t>(same));
+        Write_VarInt(out, static_cast<uint32_t>(literalEnd - literalStart));
+        out.insert(out.end(), target.begin() + literalStart, target.begin() + literalEnd);
+
+        i = literalEnd;
+    }
+}
+
+bool Rewind_Buffer::Apply_Delta(const vector<uint8_t>& base, const vector<uint8_t>& delta, vector<uint8_t>& out)
+{
+    size_t offset = 0;
+    uint32_t targetSize;
+    if (!Read_VarInt(delta, offset, targetSize)) return false;
+
+    out.resize(targetSize);
+    size_t position = 0;
+    while (offset < delta.size())
+    {
+        uint32_t same, literal;
+        if (!Read_VarInt(delta, offset, same) || !Read_VarInt(delta, offset, literal)) return false;
+        if (position + same + literal > targetSize || same > base.size() - min(base.size(), position)) return false;
+        if (offset + literal > delta.size()) return false;
+
+        memcpy(out.data() + position, base.data() + position, same);
+        position += same;
+        memcpy(out.data() + position, delta.data() + offset, literal);
+        position += literal;
+        offset += literal;
+    }
+    return position == targetSize;
+}
@@ -0,0 +1,98 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_REWIND_BUFFER_H
+#define ENDLESS_RUNNER_REWIND_BUFFER_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+// Appends plain values to a flat snapshot buffer
+class Snapshot_Writer
+{
+private:
+    vector<uint8_t>& m_buffer;
+public:
+    explicit Snapshot_Writer(vector<uint8_t>& buffer) : m_buffer(buffer) { m_buffer.clear(); }
+
+    template<typename T>
+    void Write(const T& value)
+    {
+        size_t offset = m_buffer.size();
+        m_buffer.resize(offset + sizeof(T));
+        memcpy(m_buffer.data() + offset, &value, sizeof(T));
+    }
+};
+
+// Reads plain values back out of a flat snapshot buffer
+class Snapshot_Reader
+{
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+public:
+    Snapshot_Reader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    template<typename T>
+    bool Read(T& value)
+    {
+        if (m_offset + sizeof(T) > m_size) return false;
+        memcpy(&value, m_data + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+};
+
+// Fixed-size ring of world snapshots. Every Nth frame is stored in full (a keyframe),
+// the frames in between only store what changed since the previous frame.
+class Rewind_Buffer
+{
+private:
+    struct Slot
+    {
+        uint32_t frame = 0;
+        bool isKeyframe = false;
+        bool isUsed = false;
+        vector<uint8_t> data;   // Full state for keyframes, encoded delta otherwise
+    };
+
+    vector<Slot> m_slots;
+    int m_keyframeInterval;
+    int m_head = 0;             // Next slot to write
+    int m_count = 0;
+
+    vector<uint8_t> m_previous; // Last pushed state, used as the delta base
+    size_t m_storedBytes = 0;
+
+    int Find_Slot(uint32_t frame) const;
+
+    static void Encode_Delta(const vector<uint8_t>& base, const vector<uint8_t>& target, vector<uint8_t>& out);
+    static bool Apply_Delta(const vector<uint8_t>& base, const vector<uint8_t>& delta, vector<uint8_t>& out);
+public:
+    Rewind_Buffer(int capacityFrames, int keyframeInterval);
+
+    // Store the state for a frame. Frames must be pushed in increasing order.
+    void Push(uint32_t frame, const vector<uint8_t>& state);
+
+    // Rebuild the full state of a frame that is still in the ring
+    bool Restore(uint32_t frame, vector<uint8_t>& out) const;
+
+    // Forget every frame newer than this one, so pushing can carry on from frame + 1.
+    // state is the frame's full state as Restore returned it; it becomes the next delta base.
+    bool Truncate_After(uint32_t frame, const vector<uint8_t>& state);
+
+    // Oldest frame that can still be restored (the oldest keyframe in the ring)
+    bool Oldest_Restorable(uint32_t& frame) const;
+    bool Newest(uint32_t& frame) const;
+
+    size_t Stored_Bytes() const { return m_storedBytes; }
+    void Clear();
+};
+
+
+#endif //ENDLESS_RUNNER_REWIND_BUFFER_H
@@ -0,0 +1,183 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Run_History.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace
+{
+    struct Column_Info
+    {
+        const char* file;
+        size_t size;
+    };
+
+    // Order matches Run_History::Column
+    const Column_Info COLUMNS[] = {
+            { "score.i32", sizeof(int32_t) },
+            { "coins.i32", sizeof(int32_t) },
+            { "duration.f32", sizeof(float) },
+            { "cause.u8", sizeof(uint8_t) },
+            { "seed.u32", sizeof(uint32_t) },
+            { "day.i32", sizeof(int32_t) },
+    };
+
+    int Score_Bucket(int score)
+    {
+        return clamp(score, 0, (1 << 16) - 1);
+    }
+}
+
+string Run_History::Column_Path(int column) const
+{
+    return m_directory + "/" + COLUMNS[column].file;
+}
+
+bool Run_History::Open(const string& directory)
+{
+    m_directory = directory;
+    std::error_code error;
+    filesystem::create_directories(directory, error);
+    if (error)
+    {
+        cerr << "Run history disabled, can't create " << directory << ": " << error.message() << endl;
+        return false;
+    }
+
+    // A crash between column appends leaves some columns one row longer; trim them back so rows line up
+    size_t rows = SIZE_MAX;
+    for (int column = 0; column < COLUMN_COUNT; ++column)
+    {
+        uintmax_t size = filesystem::exists(Column_Path(column)) ? filesystem::file_size(Column_Path(column), error) : 0;
+        rows = min(rows, static_cast<size_t>(size / COLUMNS[column].size));
+    }
+    for (int column = 0; column < COLUMN_COUNT; ++column)
+    {
+        string path = Column_Path(column);
+        if (filesystem::exists(path) && filesystem::file_size(path, error) != rows * COLUMNS[column].size)
+        {
+            filesystem::resize_file(path, rows * COLUMNS[column].size, error);
+        }
+        if (rows > 0) m_columns[column].Open(path);
+    }
+    m_mappedRows = rows;
+
+    m_fenwick.assign(SCORE_BUCKETS + 1, 0);
+    for (size_t row = 0; row < m_mappedRows; ++row)
+    {
+        Summarize(Read_Mapped(row));
+    }
+
+    cout << "Run history: " << m_mappedRows << " runs" << endl;
+    return true;
+}
+
+Run_Record Run_History::Read_Mapped(size_t row) const
+{
+    Run_Record record;
+    uint8_t cause;
+    memcpy(&record.score, m_columns[SCORE].Data() + row * sizeof(int32_t), sizeof(int32_t));
+    memcpy(&record.coins, m_columns[COINS].Data() + row * sizeof(int32_t), sizeof(int32_t));
+    memcpy(&record.durationSeconds, m_columns[DURATION].Data() + row * sizeof(float), sizeof(float));
+    memcpy(&cause, m_columns[CAUSE].Data() + row, sizeof(uint8_t));
+    memcpy(&record.seed, m_columns[SEED].Data() + row * sizeof(uint32_t), sizeof(uint32_t));
+    memcpy(&record.day, m_columns[DAY].Data() + row * sizeof(int32_t), sizeof(int32_t));
+    record.deathCause = static_cast<Death_Cause>(cause);
+    return record;
+}
+
+Run_Record Run_History::Get(size_t row) const
+{
+    return (row < m_mappedRows) ? Read_Mapped(row) : m_appended[row - m_mappedRows];
+}
+
+void Run_History::Summarize(const Run_Record& record)
+{
+    for (int i = Score_Bucket(record.score) + 1; i <= SCORE_BUCKETS; i += i & -i)
+    {
+        m_fenwick[i]++;
+    }
+
+    if (m_top.size() < TOP_KEEP || record.score > m_top.back())
+    {
+        m_top.insert(upper_bound(m_top.begin(), m_top.end(), record.score, greater<int32_t>()), record.score);
+        if (m_top.size() > TOP_KEEP) m_top.pop_back();
+    }
+
+    Day_Summary& day = m_days[record.day];
+    day.runs++;
+    day.bestScore = max(day.bestScore, record.score);
+    day.totalScore += record.score;
+    day.totalCoins += record.coins;
+    day.totalSeconds += record.durationSeconds;
+}
+
+void Run_History::Append(const Run_Record& record)
+{
+    if (m_directory.empty()) return;
+
+    m_appended.push_back(record);
+    Summarize(record);
+
+    uint8_t cause = static_cast<uint8_t>(record.deathCause);
+    const void* fields[COLUMN_COUNT] = { &record.score, &record.coins, &record.durationSeconds, &cause, &record.seed, &record.day };
+    for (int column = 0; column < COLUMN_COUNT; ++column)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(fields[column]);
+        m_writer.Append(Column_Path(column), vector<uint8_t>(bytes, bytes + COLUMNS[column].size));
+    }
+}
+
+vector<int> Run_History::Top(int k) const
+{
+    k = min(k, static_cast<int>(m_top.size()));
+    return vector<int>(m_top.begin(), m_top.begin() + k);
+}
+
+int Run_History::Percentile(float p) const
+{
+    size_t count = Count();
+    if (count == 0) return 0;
+
+    // Smallest bucket whose prefix count reaches the target, by walking down the tree
+    size_t target = max<size_t>(1, static_cast<size_t>(p * count + 0.5f));
+    int position = 0;
+    for (int step = SCORE_BUCKETS; step > 0; step >>= 1)
+    {
+        if (position + step <= SCORE_BUCKETS && m_fenwick[position + step] < target)
+        {
+            position += step;
+            target -= m_fenwick[position];
+        }
+    }
+    return position;   // Bucket index == score
+}
+
+float Run_History::Rank(int score) const
+{
+    size_t count = Count();
+    if (count == 0) return 0.0f;
+
+    size_t below = 0;
+    for (int i = Score_Bucket(score); i > 0; i -= i & -i)
+    {
+        below += m_fenwick[i];
+    }
+    return static_cast<float>(below) / count;
+}
+
+const Day_Summary* Run_History::Day(int32_t day) const
+{
+    auto it = m_days.find(day);
+    return (it != m_days.end()) ? &it->second : nullptr;
+}
+
+int32_t Run_History::Today()
+{
+    return static_cast<int32_t>(time(nullptr) / 86400);
+}
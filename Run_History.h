@@ -0,0 +1,95 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_RUN_HISTORY_H
+#define ENDLESS_RUNNER_RUN_HISTORY_H
+
+#include "Async_Writer.h"
+#include "Mapped_File.h"
+#include <map>
+
+enum class Death_Cause : uint8_t { UNKNOWN, SMALL_OBSTACLE, TALL_OBSTACLE, WIDE_OBSTACLE };
+
+inline const char* Death_Cause_Name(Death_Cause cause)
+{
+    const char* NAMES[] = { "unknown", "small_obstacle", "tall_obstacle", "wide_obstacle" };
+    uint8_t index = static_cast<uint8_t>(cause);
+    return index < 4 ? NAMES[index] : NAMES[0];
+}
+
+struct Run_Record
+{
+    int32_t score = 0;
+    int32_t coins = 0;
+    float durationSeconds = 0.0f;
+    Death_Cause deathCause = Death_Cause::UNKNOWN;
+    uint32_t seed = 0;
+    int32_t day = 0;            // Days since the Unix epoch (UTC)
+};
+
+struct Day_Summary
+{
+    int runs = 0;
+    int32_t bestScore = 0;
+    int64_t totalScore = 0;
+    int64_t totalCoins = 0;
+    double totalSeconds = 0.0;
+};
+
+// Every finished run, appended to one file per column in a directory and mapped for reading.
+// Summaries are built once on open and kept current on append:
+//   - a Fenwick tree over scores for percentiles and ranks, O(log n)
+//   - the best TOP_KEEP scores, sorted, for top-K
+//   - a per-day map for daily aggregates, O(log days)
+class Run_History
+{
+private:
+    static const int SCORE_BUCKETS = 1 << 16;   // Scores at or above this share the last bucket
+    static const int TOP_KEEP = 100;
+
+    enum Column { SCORE, COINS, DURATION, CAUSE, SEED, DAY, COLUMN_COUNT };
+
+    string m_directory;
+    Async_Writer m_writer;
+
+    Mapped_File m_columns[COLUMN_COUNT];
+    size_t m_mappedRows = 0;
+    vector<Run_Record> m_appended;              // Runs added since the columns were mapped
+
+    vector<uint32_t> m_fenwick;                 // 1-based, over score buckets
+    vector<int32_t> m_top;                      // Descending
+    map<int32_t, Day_Summary> m_days;
+
+    string Column_Path(int column) const;
+    Run_Record Read_Mapped(size_t row) const;
+    void Summarize(const Run_Record& record);
+public:
+    Run_History() {}
+
+    // Maps the existing columns (trimming a torn last row) and builds the summaries
+    bool Open(const string& directory);
+
+    // Adds the run to the summaries now and to the columns on the writer thread
+    void Append(const Run_Record& record);
+
+    size_t Count() const { return m_mappedRows + m_appended.size(); }
+    Run_Record Get(size_t row) const;
+
+    // Best k scores, highest first
+    vector<int> Top(int k) const;
+
+    // Score below which a fraction p (0..1) of runs fall
+    int Percentile(float p) const;
+
+    // Fraction of runs that scored strictly less than score
+    float Rank(int score) const;
+
+    const Day_Summary* Day(int32_t day) const;
+    static int32_t Today();
+
+    void Flush() { m_writer.Stop(); }
+};
+
+
+#endif //ENDLESS_RUNNER_RUN_HISTORY_H
@@ -0,0 +1,145 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Run_Telemetry.h"
+#include "Config.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+void Run_Telemetry::Init(SDL_Window* window, SDL_Renderer* renderer, float budgetMs)
+{
+    m_enabled = !Config_Flag("ER_NO_TELEMETRY");
+    m_path = Config_String("ER_TELEMETRY_PATH", "telemetry.jsonl");
+    m_budgetMs = budgetMs;
+    if (!m_enabled) return;
+
+    SDL_RendererInfo rendererInfo = {};
+    if (!renderer || SDL_GetRendererInfo(renderer, &rendererInfo) != 0) rendererInfo.name = "unknown";
+
+    SDL_DisplayMode mode = {};
+    int display = window ? SDL_GetWindowDisplayIndex(window) : 0;
+    SDL_GetCurrentDisplayMode(display < 0 ? 0 : display, &mode);
+
+    SDL_version version;
+    SDL_GetVersion(&version);
+
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+
+    char machine[512];
+    snprintf(machine, sizeof(machine),
+             "\"machine\":{\"platform\":\"%s\",\"cpus\":%d,\"ram_mb\":%d,\"renderer\":\"%s\",\"display\":\"%dx%d@%d\",\"sdl\":\"%d.%d.%d\",\"build\":\"%s\"}",
+             SDL_GetPlatform(), SDL_GetCPUCount(), SDL_GetSystemRAM(), rendererInfo.name, mode.w, mode.h, mode.refresh_rate,
+             version.major, version.minor, version.patch, build);
+    m_machine = machine;
+}
+
+int Run_Telemetry::Bucket_Index(uint32_t us)
+{
+    // Below SUB_BUCKETS every microsecond gets its own bucket; above, the top bits pick one
+    if (us < SUB_BUCKETS) return static_cast<int>(us);
+
+    int exponent = 31 - __builtin_clz(us);
+    if (exponent > MAX_EXPONENT) return BUCKET_COUNT - 1;
+    int sub = static_cast<int>((us >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+uint32_t Run_Telemetry::Bucket_Upper(int index)
+{
+    if (index < SUB_BUCKETS) return static_cast<uint32_t>(index);
+
+    int exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    int sub = index % SUB_BUCKETS;
+    uint32_t lower = (1u << exponent) + (static_cast<uint32_t>(sub) << (exponent - SUB_BUCKET_BITS));
+    return lower + (1u << (exponent - SUB_BUCKET_BITS)) - 1;
+}
+
+uint32_t Run_Telemetry::Percentile_Us(double fraction) const
+{
+    if (m_frames == 0) return 0;
+
+    uint64_t wanted = static_cast<uint64_t>(fraction * m_frames + 0.5);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += m_buckets[i];
+        if (seen >= max<uint64_t>(wanted, 1)) return min(Bucket_Upper(i), m_maxUs);
+    }
+    return m_maxUs;
+}
+
+void Run_Telemetry::Begin_Run()
+{
+    fill(begin(m_buckets), end(m_buckets), 0u);
+    m_frames = 0;
+    m_overBudget = 0;
+    m_maxUs = 0;
+    m_peaks = Peaks();
+}
+
+void Run_Telemetry::Record_Frame(bool playing, const Peaks& current)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 last = m_lastCounter;
+    m_lastCounter = now;
+    if (!m_enabled || !playing || last == 0) return;
+
+    // Frame to frame, which is what the player sees, sleep included
+    uint32_t us = static_cast<uint32_t>(min<Uint64>((now - last) * 1000000 / SDL_GetPerformanceFrequency(), UINT32_MAX));
+    m_buckets[Bucket_Index(us)]++;
+    m_frames++;
+    m_maxUs = max(m_maxUs, us);
+
+    // A quarter frame of slack absorbs SDL_Delay's granularity, anything past that is a visible hitch
+    if (us > m_budgetMs * 1250.0f) m_overBudget++;
+
+    m_peaks.obstacles = max(m_peaks.obstacles, current.obstacles);
+    m_peaks.coins = max(m_peaks.coins, current.coins);
+    m_peaks.powerUps = max(m_peaks.powerUps, current.powerUps);
+    m_peaks.ground = max(m_peaks.ground, current.ground);
+    m_peaks.residentTextureBytes = max(m_peaks.residentTextureBytes, current.residentTextureBytes);
+}
+
+void Run_Telemetry::End_Run(const Run_Info& run)
+{
+    if (!m_enabled || m_frames == 0) return;
+
+    string line;
+    char field[256];
+
+    snprintf(field, sizeof(field), "{\"time\":%lld,\"score\":%ld,\"coins\":%ld,\"seconds\":%.2f,\"seed\":%u,\"death\":\"%s\",",
+             static_cast<long long>(time(nullptr)), run.score, run.coins, run.seconds, run.seed, run.deathCause);
+    line += field;
+
+    snprintf(field, sizeof(field), "\"frames\":%u,\"budget_ms\":%.3f,\"over_budget\":%u,\"p50_ms\":%.3f,\"p95_ms\":%.3f,\"p99_ms\":%.3f,\"max_ms\":%.3f,",
+             m_frames, m_budgetMs, m_overBudget, Percentile_Us(0.50) / 1000.0, Percentile_Us(0.95) / 1000.0,
+             Percentile_Us(0.99) / 1000.0, m_maxUs / 1000.0);
+    line += field;
+
+    // Sparse: [upper bound in us, frames] for every bucket that was hit
+    line += "\"histogram_us\":[";
+    bool first = true;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        if (m_buckets[i] == 0) continue;
+        snprintf(field, sizeof(field), "%s[%u,%u]", first ? "" : ",", Bucket_Upper(i), m_buckets[i]);
+        line += field;
+        first = false;
+    }
+    line += "],";
+
+    snprintf(field, sizeof(field), "\"peak\":{\"obstacles\":%zu,\"coins\":%zu,\"power_ups\":%zu,\"ground\":%zu,\"texture_kb\":%zu},\"load_ms\":%.1f,\"reset_ms\":%.2f,",
+             m_peaks.obstacles, m_peaks.coins, m_peaks.powerUps, m_peaks.ground, m_peaks.residentTextureBytes / 1024, m_loadMs, run.resetMs);
+    line += field;
+    line += m_machine;
+    line += "}\n";
+
+    m_writer.Append(m_path, vector<uint8_t>(line.begin(), line.end()));
+    Begin_Run();
+}
@@ -0,0 +1,81 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_RUN_TELEMETRY_H
+#define ENDLESS_RUNNER_RUN_TELEMETRY_H
+
+#include "Async_Writer.h"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Per-run frame timing, appended as one JSON line per run (ER_TELEMETRY_PATH, default
+// telemetry.jsonl) so stutter reports come with numbers. ER_NO_TELEMETRY turns it off.
+class Run_Telemetry
+{
+public:
+    // Log-linear buckets over microseconds, HDR histogram style: 8 per power of two,
+    // so every bucket is within 12.5% of its values, from 1 us up to about 16 s
+    static const int SUB_BUCKET_BITS = 3;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int MAX_EXPONENT = 24;
+    static const int BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    struct Run_Info
+    {
+        long score;
+        long coins;
+        float seconds;
+        unsigned int seed;
+        const char* deathCause;
+        double resetMs;         // How long Reset_Game took to set the run up
+    };
+
+    struct Peaks
+    {
+        size_t obstacles = 0;
+        size_t coins = 0;
+        size_t powerUps = 0;
+        size_t ground = 0;
+        size_t residentTextureBytes = 0;
+    };
+private:
+    bool m_enabled = false;
+    string m_path;
+    string m_machine;           // Built once, the same for every run
+    float m_budgetMs = 1000.0f / 60.0f;
+    double m_loadMs = 0.0;
+
+    Uint64 m_lastCounter = 0;
+    uint32_t m_buckets[BUCKET_COUNT] = {};
+    uint32_t m_frames = 0;
+    uint32_t m_overBudget = 0;
+    uint32_t m_maxUs = 0;
+    Peaks m_peaks;
+
+    Async_Writer m_writer;
+
+    static int Bucket_Index(uint32_t us);
+    static uint32_t Bucket_Upper(int index);
+    uint32_t Percentile_Us(double fraction) const;
+public:
+    // Once the renderer exists, so the machine info can name it
+    void Init(SDL_Window* window, SDL_Renderer* renderer, float budgetMs);
+    void Set_Load_Time(double ms) { m_loadMs = ms; }
+
+    void Begin_Run();
+
+    // Every frame, so the interval is right on the first played one; only counted while playing
+    void Record_Frame(bool playing, const Peaks& current);
+
+    // Builds the line on this thread, the append happens on the writer thread
+    void End_Run(const Run_Info& run);
+
+    void Stop() { m_writer.Stop(); }
+};
+
+
+#endif //ENDLESS_RUNNER_RUN_TELEMETRY_H
@@ -0,0 +1,124 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Stress_Test.h"
+#include "Config.h"
+#include "Frame_Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+void Stress_Test::Configure()
+{
+    m_spawnFactor = max(1.0f, Config_Float("ER_STRESS_FACTOR", 1.0f));
+    m_stageSeconds = max(1.0f, Config_Float("ER_STRESS_STAGE_SECONDS", 20.0f));
+    m_logPath = Config_String("ER_STRESS_LOG", "stress.csv");
+
+    stringstream stages(Config_String("ER_STRESS_ENTITIES", ""));
+    string count;
+    while (getline(stages, count, ','))
+    {
+        int value = atoi(count.c_str());
+        if (value > 0) m_stages.push_back(value);
+    }
+
+    m_active = m_spawnFactor > 1.0f || !m_stages.empty();
+    if (!m_active) return;
+
+#ifndef ER_PROFILER_ENABLED
+    cout << "Stress test: built with ER_PROFILER=OFF, so only frame times are logged" << endl;
+#endif
+    cout << "Stress test: spawn factor " << m_spawnFactor << ", " << m_stages.size() << " pinned stages, logging to " << m_logPath << endl;
+
+    string header = "seconds,target,entities,frames,frame_ms,frame_p99_ms,work_ms,physics_ms,render_ms,present_ms\n";
+    m_writer.Write(m_logPath, vector<uint8_t>(header.begin(), header.end()));
+}
+
+bool Stress_Test::Record_Frame(size_t liveEntities)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (m_lastFrame == 0)
+    {
+        m_lastFrame = now;
+        return true;
+    }
+
+    float frameMs = static_cast<float>((now - m_lastFrame) * 1000.0 / SDL_GetPerformanceFrequency());
+    m_lastFrame = now;
+    m_elapsed += frameMs / 1000.0f;
+
+    m_window.frames++;
+    m_window.frameMs += frameMs;
+    m_window.workMs += frameMs;
+    m_window.frameTimes.push_back(frameMs);
+    m_window.entities = liveEntities;
+
+#ifdef ER_PROFILER_ENABLED
+    const Frame_Profiler& profiler = Frame_Profiler::GetInstance();
+    const Frame_Profiler::Frame_Sample& sample = profiler.Frame(profiler.Completed() - 1);
+    m_window.workMs -= sample.phaseMs[static_cast<int>(Profile_Phase::SLEEP)];
+    m_window.physicsMs += sample.phaseMs[static_cast<int>(Profile_Phase::PHYSICS)];
+    // Phases are exclusive, and the HUD is drawn inside the render scope
+    m_window.renderMs += sample.phaseMs[static_cast<int>(Profile_Phase::RENDER)] + sample.phaseMs[static_cast<int>(Profile_Phase::RENDER_UI)];
+    m_window.presentMs += sample.phaseMs[static_cast<int>(Profile_Phase::PRESENT)];
+#endif
+
+    if (m_elapsed - m_windowStart >= 1.0f) Write_Row();
+
+    if (!m_stages.empty() && m_elapsed >= (m_stage + 1) * m_stageSeconds)
+    {
+        Finish_Stage();
+        if (++m_stage >= static_cast<int>(m_stages.size())) return false;
+    }
+    return true;
+}
+
+void Stress_Test::Write_Row()
+{
+    Window& window = m_window;
+    if (window.frames == 0) return;
+
+    sort(window.frameTimes.begin(), window.frameTimes.end());
+    float p99 = window.frameTimes[min(window.frameTimes.size() - 1, window.frameTimes.size() * 99 / 100)];
+
+    char row[256];
+    snprintf(row, sizeof(row), "%.1f,%d,%zu,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+             m_elapsed, Target_Entities(), window.entities, window.frames,
+             window.frameMs / window.frames, p99, window.workMs / window.frames,
+             window.physicsMs / window.frames, window.renderMs / window.frames, window.presentMs / window.frames);
+    m_writer.Append(m_logPath, vector<uint8_t>(row, row + strlen(row)));
+
+    m_stageTotals.frames += window.frames;
+    m_stageTotals.workMs += window.workMs;
+    m_stageTotals.physicsMs += window.physicsMs;
+    m_stageTotals.renderMs += window.renderMs;
+    m_stageTotals.entities = window.entities;
+
+    m_window = Window();
+    m_windowStart = m_elapsed;
+}
+
+void Stress_Test::Finish_Stage()
+{
+    Write_Row();
+
+    const Window& totals = m_stageTotals;
+    if (totals.frames > 0)
+    {
+        cout << "Stress stage " << Target_Entities() << " entities (" << totals.entities << " live): "
+             << totals.workMs / totals.frames << " ms work, "
+             << totals.physicsMs / totals.frames << " ms physics, "
+             << totals.renderMs / totals.frames << " ms render per frame" << endl;
+    }
+    m_stageTotals = Window();
+}
+
+void Stress_Test::Stop()
+{
+    if (!m_active) return;
+    Write_Row();
+    m_writer.Stop();
+}
@@ -0,0 +1,67 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_STRESS_TEST_H
+#define ENDLESS_RUNNER_STRESS_TEST_H
+
+#include "Async_Writer.h"
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Drives the engine at entity counts gameplay never reaches, and logs how frame, physics and
+// render times scale with them. Either multiplies the normal spawn rate (ER_STRESS_FACTOR), or
+// holds the live entity count at each value of ER_STRESS_ENTITIES (e.g. "1000,10000,100000")
+// for ER_STRESS_STAGE_SECONDS, then quits. Once a second, a CSV row goes to ER_STRESS_LOG.
+class Stress_Test
+{
+private:
+    struct Window
+    {
+        int frames = 0;
+        double frameMs = 0.0;
+        double workMs = 0.0;        // Frame minus the sleep
+        double physicsMs = 0.0;
+        double renderMs = 0.0;
+        double presentMs = 0.0;
+        vector<float> frameTimes;   // For the p99
+        size_t entities = 0;
+    };
+
+    bool m_active = false;
+    float m_spawnFactor = 1.0f;
+    vector<int> m_stages;
+    float m_stageSeconds = 20.0f;
+    string m_logPath;
+
+    Uint64 m_lastFrame = 0;
+    float m_elapsed = 0.0f;
+    float m_windowStart = 0.0f;
+    Window m_window;
+    Window m_stageTotals;
+    int m_stage = 0;
+    Async_Writer m_writer;
+
+    void Write_Row();
+    void Finish_Stage();
+public:
+    // Reads the ER_STRESS_ settings; does nothing unless one of them is set
+    void Configure();
+
+    bool Active() const { return m_active; }
+    float Spawn_Factor() const { return m_spawnFactor; }
+
+    // Live entities to hold right now, 0 when only the spawn factor applies
+    int Target_Entities() const { return m_stage < static_cast<int>(m_stages.size()) ? m_stages[m_stage] : 0; }
+
+    // Once per played frame, after the profiler has closed it. Returns false when the last stage is done.
+    bool Record_Frame(size_t liveEntities);
+
+    void Stop();
+};
+
+
+#endif //ENDLESS_RUNNER_STRESS_TEST_H
@@ -0,0 +1,251 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Texture_Cache.h"
+#include "Asset_Archive.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sys/stat.h>
+#include <vector>
+
+namespace
+{
+    const char BLOB_MAGIC[4] = { 'E', 'R', 'T', 'C' };
+    const uint32_t BLOB_VERSION = 1;
+
+    struct Blob_Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t pathHash;
+        uint64_t sourceKey;
+        uint32_t width;
+        uint32_t height;
+        uint32_t pitch;
+        uint32_t reserved;
+    };
+
+    // FNV-1a
+    uint64_t Hash_Bytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t File_Key(const string& path)
+    {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return 0;
+
+        int64_t stamp[2] = { static_cast<int64_t>(info.st_mtime), static_cast<int64_t>(info.st_size) };
+        return Hash_Bytes(stamp, sizeof(stamp));
+    }
+
+    void Unpremultiply(const Texture_Cache::Pixels& pixels, uint8_t* out)
+    {
+        for (int y = 0; y < pixels.height; ++y)
+        {
+            const uint8_t* source = static_cast<const uint8_t*>(pixels.data) + static_cast<size_t>(y) * pixels.pitch;
+            uint8_t* target = out + static_cast<size_t>(y) * pixels.width * 4;
+            for (int x = 0; x < pixels.width * 4; x += 4)
+            {
+                uint32_t alpha = source[x + 3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    target[x + c] = alpha == 0 ? 0 : static_cast<uint8_t>(min<uint32_t>(255, (source[x + c] * 255u + alpha / 2) / alpha));
+                }
+                target[x + 3] = static_cast<uint8_t>(alpha);
+            }
+        }
+    }
+}
+
+void Texture_Cache::Open(const string& directory)
+{
+    std::error_code error;
+    filesystem::create_directories(directory, error);
+    if (error)
+    {
+        cerr << "Texture cache disabled, can't create " << directory << ": " << error.message() << endl;
+        return;
+    }
+    m_directory = directory;
+}
+
+string Texture_Cache::Blob_Path(const string& path) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.rgba", static_cast<unsigned long long>(Hash_Bytes(path.data(), path.size())));
+    return m_directory + "/" + name;
+}
+
+bool Texture_Cache::Load(const string& name, const string& path, Pixels& out)
+{
+    // Packed assets are keyed by their bytes, loose files by mtime and size
+    const uint8_t* packed = nullptr;
+    size_t packedSize = 0;
+    bool isPacked = Asset_Archive::GetInstance().Find(name, packed, packedSize);
+    uint64_t sourceKey = isPacked ? Hash_Bytes(packed, packedSize) : File_Key(path);
+
+    if (!m_directory.empty() && sourceKey != 0 && Read_Blob(path, sourceKey, out))
+    {
+        m_hits++;
+        return true;
+    }
+    m_misses++;
+
+    SDL_RWops* source = isPacked ? SDL_RWFromConstMem(packed, static_cast<int>(packedSize)) : SDL_RWFromFile(path.c_str(), "rb");
+    if (!source || !Decode(source, out)) return false;
+
+    if (!m_directory.empty() && sourceKey != 0) Write_Blob(path, sourceKey, out);
+    return true;
+}
+
+bool Texture_Cache::Refresh(const string& path, Pixels& out)
+{
+    SDL_RWops* source = SDL_RWFromFile(path.c_str(), "rb");
+    if (!source || !Decode(source, out)) return false;
+
+    uint64_t sourceKey = File_Key(path);
+    if (!m_directory.empty() && sourceKey != 0) Write_Blob(path, sourceKey, out);
+    return true;
+}
+
+bool Texture_Cache::Read_Blob(const string& path, uint64_t sourceKey, Pixels& out) const
+{
+    if (!out.blob.Open(Blob_Path(path))) return false;
+
+    Blob_Header header;
+    if (out.blob.Size() < sizeof(header))
+    {
+        out.blob.Close();
+        return false;
+    }
+    memcpy(&header, out.blob.Data(), sizeof(header));
+
+    bool valid = memcmp(header.magic, BLOB_MAGIC, sizeof(BLOB_MAGIC)) == 0
+                 && header.version == BLOB_VERSION
+                 && header.pathHash == Hash_Bytes(path.data(), path.size())
+                 && header.sourceKey == sourceKey
+                 && header.pitch == header.width * 4
+                 && out.blob.Size() >= sizeof(header) + static_cast<size_t>(header.pitch) * header.height;
+    if (!valid)
+    {
+        out.blob.Close();
+        return false;
+    }
+
+    out.data = out.blob.Data() + sizeof(header);
+    out.width = static_cast<int>(header.width);
+    out.height = static_cast<int>(header.height);
+    out.pitch = static_cast<int>(header.pitch);
+    return true;
+}
+
+bool Texture_Cache::Decode(SDL_RWops* source, Pixels& out) const
+{
+    SDL_Surface* decoded = IMG_Load_RW(source, 1);
+    if (!decoded)
+    {
+        cerr << "Failed to decode texture | Error: " << IMG_GetError() << endl;
+        return false;
+    }
+
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(decoded);
+    if (!rgba)
+    {
+        cerr << "Failed to convert texture | Error: " << SDL_GetError() << endl;
+        return false;
+    }
+
+    // Premultiplied pixels scale without dark fringes at transparent edges, and are stored ready to upload
+    SDL_PremultiplyAlpha(rgba->w, rgba->h, SDL_PIXELFORMAT_RGBA32, rgba->pixels, rgba->pitch,
+                         SDL_PIXELFORMAT_RGBA32, rgba->pixels, rgba->pitch);
+
+    out.surface = rgba;
+    out.data = rgba->pixels;
+    out.width = rgba->w;
+    out.height = rgba->h;
+    out.pitch = rgba->pitch;
+    return true;
+}
+
+void Texture_Cache::Write_Blob(const string& path, uint64_t sourceKey, const Pixels& pixels) const
+{
+    Blob_Header header = {};
+    memcpy(header.magic, BLOB_MAGIC, sizeof(BLOB_MAGIC));
+    header.version = BLOB_VERSION;
+    header.pathHash = Hash_Bytes(path.data(), path.size());
+    header.sourceKey = sourceKey;
+    header.width = static_cast<uint32_t>(pixels.width);
+    header.height = static_cast<uint32_t>(pixels.height);
+    header.pitch = header.width * 4;
+
+    // Written next to the blob and renamed over it, so a crash never leaves a torn blob behind
+    string blobPath = Blob_Path(path);
+    string tempPath = blobPath + ".tmp";
+    {
+        ofstream file(tempPath, ios::binary | ios::trunc);
+        if (!file) return;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        const char* row = static_cast<const char*>(pixels.data);
+        for (int y = 0; y < pixels.height; ++y)
+        {
+            file.write(row + static_cast<size_t>(y) * pixels.pitch, header.pitch);
+        }
+        if (!file)
+        {
+            cerr << "Failed to write texture cache blob: " << tempPath << endl;
+            return;
+        }
+    }
+
+    std::error_code error;
+    filesystem::rename(tempPath, blobPath, error);
+    if (error) filesystem::remove(tempPath, error);
+}
+
+SDL_Texture* Texture_Cache::Upload(SDL_Renderer* renderer, const Pixels& pixels)
+{
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, pixels.width, pixels.height);
+    if (!texture) return nullptr;
+
+    if (SDL_UpdateTexture(texture, NULL, pixels.data, pixels.pitch) != 0)
+    {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+
+    static const SDL_BlendMode PREMULTIPLIED = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if (SDL_SetTextureBlendMode(texture, PREMULTIPLIED) == 0) return texture;
+
+    // Renderers without custom blend modes (e.g. software) get the pixels back in straight alpha,
+    // otherwise every sprite would draw as an opaque box
+    vector<uint8_t> straight(static_cast<size_t>(pixels.width) * pixels.height * 4);
+    Unpremultiply(pixels, straight.data());
+    if (SDL_UpdateTexture(texture, NULL, straight.data(), pixels.width * 4) != 0)
+    {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+void Texture_Cache::Print_Stats() const
+{
+    if (m_directory.empty()) return;
+    cout << "Texture cache: " << m_hits << " hits, " << m_misses << " misses (" << m_directory << ")" << endl;
+}
@@ -0,0 +1,67 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_TEXTURE_CACHE_H
+#define ENDLESS_RUNNER_TEXTURE_CACHE_H
+
+#include "Mapped_File.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <atomic>
+#include <iostream>
+
+// On-disk cache of decoded texture pixels, so warm launches skip PNG inflate entirely.
+// Each blob holds premultiplied RGBA32 rows plus the key of the source it was made from
+// (file mtime and size, or a hash of the packed bytes), and is named after a hash of the path.
+class Texture_Cache
+{
+public:
+    // Pixels ready for SDL_UpdateTexture: mapped straight from a blob, or owned by a decoded surface
+    struct Pixels
+    {
+        Mapped_File blob;
+        SDL_Surface* surface = nullptr;
+        const void* data = nullptr;
+        int width = 0;
+        int height = 0;
+        int pitch = 0;
+
+        ~Pixels() { if (surface) SDL_FreeSurface(surface); }
+    };
+private:
+    Texture_Cache() {}
+
+    string m_directory;         // Empty = cache disabled, decode every time
+    atomic<int> m_hits{0};
+    atomic<int> m_misses{0};
+
+    string Blob_Path(const string& path) const;
+    bool Read_Blob(const string& path, uint64_t sourceKey, Pixels& out) const;
+    bool Decode(SDL_RWops* source, Pixels& out) const;
+    void Write_Blob(const string& path, uint64_t sourceKey, const Pixels& pixels) const;
+public:
+    static Texture_Cache& GetInstance()
+    {
+        static Texture_Cache instance;
+        return instance;
+    }
+
+    void Open(const string& directory);
+
+    // Thread safe. Uses the blob when it still matches the source, otherwise decodes
+    // (from the archive if the asset is packed) and rewrites the blob.
+    bool Load(const string& name, const string& path, Pixels& out);
+
+    // Decode the file on disk regardless of the archive or the blob (hot reload)
+    bool Refresh(const string& path, Pixels& out);
+
+    // Main thread only. The texture uses a premultiplied-alpha blend mode, or, where the renderer
+    // rejects custom blend modes, straight-alpha pixels with SDL_BLENDMODE_BLEND.
+    static SDL_Texture* Upload(SDL_Renderer* renderer, const Pixels& pixels);
+
+    void Print_Stats() const;
+};
+
+
+#endif //ENDLESS_RUNNER_TEXTURE_CACHE_H
@@ -0,0 +1,154 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Trace_Recorder.h"
+#include "Async_Writer.h"
+#include "Config.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    thread_local Trace_Recorder::Thread_Buffer* t_buffer = nullptr;
+
+    void Append_Json_String(string& out, const char* text)
+    {
+        out += '"';
+        for (const char* c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\') out += '\\';
+            if (static_cast<unsigned char>(*c) < 0x20) continue;
+            out += *c;
+        }
+        out += '"';
+    }
+}
+
+Trace_Recorder::Trace_Recorder()
+{
+    // ER_TRACE=<file> turns recording on; the trace is written at exit and whenever F2 is pressed
+    const char* path = Config_String("ER_TRACE", "");
+    m_enabled = *path != '\0';
+    m_path = path;
+    m_origin = SDL_GetPerformanceCounter();
+    m_ticksToUs = 1000000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+Trace_Recorder::Thread_Buffer* Trace_Recorder::Register_Thread()
+{
+    // The one allocation per thread, on its first event
+    auto buffer = make_unique<Thread_Buffer>();
+    buffer->events = make_unique<Event[]>(EVENTS_PER_THREAD);
+
+    lock_guard<mutex> lock(m_threadsMutex);
+    buffer->id = static_cast<int>(m_threads.size()) + 1;
+    buffer->name = "Thread " + to_string(buffer->id);
+    m_threads.push_back(std::move(buffer));
+    return m_threads.back().get();
+}
+
+void Trace_Recorder::Name_Thread(const char* name)
+{
+    if (!m_enabled) return;
+    if (!t_buffer) t_buffer = Register_Thread();
+
+    lock_guard<mutex> lock(m_threadsMutex);
+    t_buffer->name = name;
+}
+
+void Trace_Recorder::Record(const char* name, Uint64 start, Uint64 end, const char* detail)
+{
+    if (!m_enabled) return;
+    if (!t_buffer) t_buffer = Register_Thread();
+
+    // Full rings overwrite their oldest event. Claiming first tells a concurrent Flush the slot is dirty.
+    uint64_t sequence = t_buffer->written.load(memory_order_relaxed);
+    t_buffer->claimed.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    Event& event = t_buffer->events[sequence % EVENTS_PER_THREAD];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    if (detail)
+    {
+        strncpy(event.detail, detail, DETAIL_LENGTH - 1);
+        event.detail[DETAIL_LENGTH - 1] = '\0';
+    }
+    else
+    {
+        event.detail[0] = '\0';
+    }
+
+    t_buffer->written.store(sequence + 1, memory_order_release);
+}
+
+bool Trace_Recorder::Flush()
+{
+    if (!m_enabled) return false;
+
+    string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    size_t eventCount = 0;
+    uint64_t overwritten = 0;
+    vector<Event> events;
+
+    lock_guard<mutex> lock(m_threadsMutex);
+    for (const auto& buffer : m_threads)
+    {
+        json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + to_string(buffer->id) + ",\"args\":{\"name\":";
+        Append_Json_String(json, buffer->name.c_str());
+        json += "}},\n";
+
+        // Copy the ring oldest first, then drop any event its writer lapped while it was being copied
+        uint64_t written = buffer->written.load(memory_order_acquire);
+        uint64_t first = written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD : 0;
+        events.clear();
+        for (uint64_t sequence = first; sequence < written; ++sequence)
+        {
+            events.push_back(buffer->events[sequence % EVENTS_PER_THREAD]);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t claimed = buffer->claimed.load(memory_order_relaxed);
+        uint64_t firstIntact = claimed > EVENTS_PER_THREAD ? claimed - EVENTS_PER_THREAD : 0;
+        size_t skip = static_cast<size_t>(min(written, max(first, firstIntact)) - first);
+        overwritten += written - events.size() + skip;
+
+        char line[128];
+        for (size_t i = skip; i < events.size(); ++i)
+        {
+            const Event& event = events[i];
+
+            // Complete events: a start and a duration, in microseconds since startup
+            json += "{\"ph\":\"X\",\"pid\":1,\"tid\":" + to_string(buffer->id) + ",\"name\":";
+            Append_Json_String(json, event.name);
+            snprintf(line, sizeof(line), ",\"ts\":%.3f,\"dur\":%.3f",
+                     (event.start - m_origin) * m_ticksToUs, (event.end - event.start) * m_ticksToUs);
+            json += line;
+            if (event.detail[0])
+            {
+                json += ",\"args\":{\"detail\":";
+                Append_Json_String(json, event.detail);
+                json += "}";
+            }
+            json += "},\n";
+        }
+        eventCount += events.size() - skip;
+    }
+
+    // Trailing metadata event so every real event can end in a comma
+    json += "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"args\":{\"name\":\"Endless_Runner\"}}\n]}\n";
+
+    vector<uint8_t> data(json.begin(), json.end());
+    if (!Async_Writer::Write_File_Atomic(m_path, data))
+    {
+        cerr << "Failed to write trace: " << m_path << endl;
+        return false;
+    }
+
+    cout << "Trace: " << eventCount << " events from " << m_threads.size() << " threads written to " << m_path;
+    if (overwritten) cout << " (" << overwritten << " older events overwritten)";
+    cout << endl;
+    return true;
+}
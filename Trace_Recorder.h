@@ -0,0 +1,106 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_TRACE_RECORDER_H
+#define ENDLESS_RUNNER_TRACE_RECORDER_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Records timed events from any thread into per-thread rings, and writes them out as a
+// Chrome trace_event JSON file (open in Perfetto or chrome://tracing). Recording never
+// allocates or touches the disk; the file is only built when Flush() is called, and holds
+// the most recent events of each thread.
+class Trace_Recorder
+{
+public:
+    static const int DETAIL_LENGTH = 32;
+    static const uint32_t EVENTS_PER_THREAD = 1 << 16;   // About 3.5 MB, roughly the last 100 s of main thread frames
+
+    struct Event
+    {
+        const char* name;               // Must be a string literal, it's stored as a pointer
+        Uint64 start;
+        Uint64 end;
+        char detail[DETAIL_LENGTH];     // Optional copied argument, like an asset name
+    };
+
+    // Only its owning thread writes to a ring. Event n goes in slot n % EVENTS_PER_THREAD; the
+    // writer bumps claimed before touching a slot and written after, so Flush can copy the ring
+    // while it's being written and keep only the events that weren't overwritten meanwhile.
+    struct Thread_Buffer
+    {
+        string name;
+        int id = 0;
+        unique_ptr<Event[]> events;
+        atomic<uint64_t> claimed{0};
+        atomic<uint64_t> written{0};
+    };
+private:
+    Trace_Recorder();
+
+    bool m_enabled = false;
+    string m_path;
+    Uint64 m_origin = 0;
+    double m_ticksToUs;
+
+    mutex m_threadsMutex;   // Only taken when a thread records for the first time, and by Flush
+    vector<unique_ptr<Thread_Buffer>> m_threads;
+
+    Thread_Buffer* Register_Thread();
+public:
+    static Trace_Recorder& GetInstance()
+    {
+        static Trace_Recorder instance;
+        return instance;
+    }
+
+    bool Enabled() const { return m_enabled; }
+
+    // Label the calling thread in the trace viewer
+    void Name_Thread(const char* name);
+
+    void Record(const char* name, Uint64 start, Uint64 end, const char* detail = nullptr);
+
+    // Writes what the rings hold now. Call between frames, or at exit.
+    bool Flush();
+};
+
+class Trace_Scope
+{
+private:
+    const char* m_name;
+    const char* m_detail;
+    Uint64 m_start;
+public:
+    Trace_Scope(const char* name, const char* detail = nullptr)
+        : m_name(name), m_detail(detail), m_start(Trace_Recorder::GetInstance().Enabled() ? SDL_GetPerformanceCounter() : 0) {}
+    ~Trace_Scope()
+    {
+        if (m_start) Trace_Recorder::GetInstance().Record(m_name, m_start, SDL_GetPerformanceCounter(), m_detail);
+    }
+};
+
+// Compiled out along with the frame profiler (-DER_PROFILER=OFF)
+#ifdef ER_PROFILER_ENABLED
+#define ER_TRACE_CONCAT_(a, b) a##b
+#define ER_TRACE_CONCAT(a, b) ER_TRACE_CONCAT_(a, b)
+#define ER_TRACE_SCOPE(name) Trace_Scope ER_TRACE_CONCAT(er_trace_scope_, __LINE__)(name)
+#define ER_TRACE_SCOPE_DETAIL(name, detail) Trace_Scope ER_TRACE_CONCAT(er_trace_scope_, __LINE__)(name, detail)
+#define ER_TRACE_THREAD(name) Trace_Recorder::GetInstance().Name_Thread(name)
+#else
+#define ER_TRACE_SCOPE(name) ((void)0)
+#define ER_TRACE_SCOPE_DETAIL(name, detail) ((void)0)
+#define ER_TRACE_THREAD(name) ((void)0)
+#endif
+
+
+#endif //ENDLESS_RUNNER_TRACE_RECORDER_H
@@ -0,0 +1,187 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "UI_Tree.h"
+
+UI_Tree::~UI_Tree()
+{
+    for (UI_Widget& widget : m_widgets)
+    {
+        if (widget.textTexture) SDL_DestroyTexture(widget.textTexture);
+    }
+}
+
+int UI_Tree::Add(UI_Widget widget)
+{
+    Measure(widget);
+    m_widgets.push_back(move(widget));
+    m_layoutDirty = true;
+    return static_cast<int>(m_widgets.size()) - 1;
+}
+
+void UI_Tree::Measure(UI_Widget& widget)
+{
+    widget.textWidth = 0;
+    widget.textHeight = 0;
+    if (widget.font && !widget.text.empty())
+    {
+        TTF_SizeText(widget.font, widget.text.c_str(), &widget.textWidth, &widget.textHeight);
+    }
+}
+
+int UI_Tree::Add_Panel(int parent, UI_Align align, int x, int y, int width, int height)
+{
+    UI_Widget widget{ UI_Widget::Kind::PANEL, parent };
+    widget.align = align;
+    widget.offsetX = x;
+    widget.offsetY = y;
+    widget.width = width;
+    widget.height = height;
+    return Add(move(widget));
+}
+
+int UI_Tree::Add_Label(int parent, TTF_Font* font, const string& text, UI_Align align, int x, int y, SDL_Color color)
+{
+    UI_Widget widget{ UI_Widget::Kind::LABEL, parent };
+    widget.align = align;
+    widget.offsetX = x;
+    widget.offsetY = y;
+    widget.width = 0;
+    widget.height = 0;
+    widget.font = font;
+    widget.text = text;
+    widget.textColor = color;
+    return Add(move(widget));
+}
+
+int UI_Tree::Add_Button(int parent, TTF_Font* font, const string& text, UI_Align align, int x, int y, int width, int height)
+{
+    UI_Widget widget{ UI_Widget::Kind::BUTTON, parent };
+    widget.align = align;
+    widget.offsetX = x;
+    widget.offsetY = y;
+    widget.width = width;
+    widget.height = height;
+    widget.font = font;
+    widget.text = text;
+    return Add(move(widget));
+}
+
+int UI_Tree::Add_Image(int parent, Texture_Handle image, UI_Align align, int x, int y, int width, int height)
+{
+    UI_Widget widget{ UI_Widget::Kind::IMAGE, parent };
+    widget.align = align;
+    widget.offsetX = x;
+    widget.offsetY = y;
+    widget.width = width;
+    widget.height = height;
+    widget.image = image;
+    return Add(move(widget));
+}
+
+void UI_Tree::Set_Text(int id, const string& text)
+{
+    UI_Widget& widget = m_widgets[id];
+    if (widget.text == text) return;
+
+    widget.text = text;
+    Measure(widget);
+    if (widget.textTexture)
+    {
+        SDL_DestroyTexture(widget.textTexture);
+        widget.textTexture = nullptr;
+    }
+    m_layoutDirty = true;
+}
+
+void UI_Tree::Set_Visible(int id, bool visible)
+{
+    if (m_widgets[id].visible == visible) return;
+    m_widgets[id].visible = visible;
+    m_layoutDirty = true;
+}
+
+void UI_Tree::Layout(int screenWidth, int screenHeight)
+{
+    if (!m_layoutDirty && screenWidth == m_layoutWidth && screenHeight == m_layoutHeight) return;
+
+    const SDL_Rect screen = { 0, 0, screenWidth, screenHeight };
+    for (UI_Widget& widget : m_widgets)
+    {
+        const SDL_Rect& parent = widget.parent < 0 ? screen : m_widgets[widget.parent].bounds;
+        widget.shown = widget.visible && (widget.parent < 0 || m_widgets[widget.parent].shown);
+
+        int width = widget.width > 0 ? widget.width : widget.textWidth;
+        int height = widget.height > 0 ? widget.height : widget.textHeight;
+        int x = widget.align == UI_Align::CENTER ? parent.x + parent.w / 2 + widget.offsetX - width / 2 : parent.x + widget.offsetX;
+        widget.bounds = { x, parent.y + widget.offsetY, width, height };
+
+        widget.textRect = {
+                x + (width - widget.textWidth) / 2,
+                widget.bounds.y + (height - widget.textHeight) / 2,
+                widget.textWidth,
+                widget.textHeight
+        };
+    }
+
+    m_layoutWidth = screenWidth;
+    m_layoutHeight = screenHeight;
+    m_layoutDirty = false;
+}
+
+void UI_Tree::Render(SDL_Renderer* renderer, int screenWidth, int screenHeight)
+{
+    Layout(screenWidth, screenHeight);
+
+    for (UI_Widget& widget : m_widgets)
+    {
+        if (!widget.shown) continue;
+
+        if (widget.fill.a > 0)
+        {
+            SDL_SetRenderDrawColor(renderer, widget.fill.r, widget.fill.g, widget.fill.b, widget.fill.a);
+            SDL_RenderFillRect(renderer, &widget.bounds);
+        }
+        if (widget.border.a > 0)
+        {
+            SDL_SetRenderDrawColor(renderer, widget.border.r, widget.border.g, widget.border.b, widget.border.a);
+            SDL_RenderDrawRect(renderer, &widget.bounds);
+        }
+
+        if (widget.kind == UI_Widget::Kind::IMAGE)
+        {
+            SDL_Texture* texture = Asset_Manager::GetInstance().GetTexture(widget.image);
+            if (texture) SDL_RenderCopy(renderer, texture, NULL, &widget.bounds);
+            continue;
+        }
+
+        if (widget.textWidth == 0) continue;
+        if (!widget.textTexture)
+        {
+            SDL_Surface* surface = TTF_RenderText_Blended(widget.font, widget.text.c_str(), widget.textColor);
+            if (!surface) continue;
+            widget.textTexture = SDL_CreateTextureFromSurface(renderer, surface);
+            SDL_FreeSurface(surface);
+            if (!widget.textTexture) continue;
+        }
+        SDL_RenderCopy(renderer, widget.textTexture, NULL, &widget.textRect);
+    }
+}
+
+int UI_Tree::Hit_Test(int x, int y)
+{
+    // Catches changes made since the last draw, e.g. a button shown by the same event's handler
+    if (m_layoutWidth >= 0) Layout(m_layoutWidth, m_layoutHeight);
+
+    SDL_Point point = { x, y };
+    for (int i = static_cast<int>(m_widgets.size()) - 1; i >= 0; --i)
+    {
+        const UI_Widget& widget = m_widgets[i];
+        if (widget.kind == UI_Widget::Kind::BUTTON && widget.shown && SDL_PointInRect(&point, &widget.bounds))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,89 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_UI_TREE_H
+#define ENDLESS_RUNNER_UI_TREE_H
+
+#include "Asset_Manager.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// LEFT places a widget's left edge offsetX from its parent's left edge,
+// CENTER places its middle offsetX from its parent's middle
+enum class UI_Align { LEFT, CENTER };
+
+struct UI_Widget
+{
+    enum class Kind { PANEL, LABEL, BUTTON, IMAGE };
+    Kind kind;
+    int parent;                 // -1 for the screen; always added before its children
+    bool visible = true;
+
+    // Layout
+    UI_Align align;
+    int offsetX, offsetY;       // offsetY is always from the parent's top
+    int width, height;          // 0 = fit the text
+
+    // Content
+    string text;
+    TTF_Font* font = nullptr;
+    SDL_Color textColor = { 200, 200, 200, 255 };
+    SDL_Color fill = { 0, 0, 0, 0 };        // Alpha 0 = none
+    SDL_Color border = { 0, 0, 0, 0 };
+    Texture_Handle image;
+
+    // Cached: measured when the text changes, the texture made on the next draw
+    int textWidth = 0, textHeight = 0;
+    SDL_Texture* textTexture = nullptr;
+    SDL_Rect bounds = { 0, 0, 0, 0 };
+    SDL_Rect textRect = { 0, 0, 0, 0 };     // Centered in bounds
+    bool shown = true;                      // Visible, and so are all its parents
+};
+
+// Retained menu layer. Screens are built once; labels only re-render their text texture when
+// Set_Text changes it, and layout runs only after a change or a resize. Drawing is a walk over
+// cached rects and textures, and clicks are hit-tested against the same rects.
+class UI_Tree
+{
+private:
+    vector<UI_Widget> m_widgets;
+    int m_layoutWidth = -1;
+    int m_layoutHeight = -1;
+    bool m_layoutDirty = true;
+
+    int Add(UI_Widget widget);
+    void Measure(UI_Widget& widget);
+public:
+    UI_Tree() = default;
+    UI_Tree(const UI_Tree&) = delete;
+    UI_Tree& operator=(const UI_Tree&) = delete;
+    ~UI_Tree();
+
+    // Each returns the widget's id
+    int Add_Panel(int parent, UI_Align align, int x, int y, int width, int height);
+    int Add_Label(int parent, TTF_Font* font, const string& text, UI_Align align, int x, int y, SDL_Color color = { 200, 200, 200, 255 });
+    int Add_Button(int parent, TTF_Font* font, const string& text, UI_Align align, int x, int y, int width = 0, int height = 0);
+    int Add_Image(int parent, Texture_Handle image, UI_Align align, int x, int y, int width, int height);
+
+    // Cheap when nothing changed, so callers can push the current values whenever they like
+    void Set_Text(int id, const string& text);
+    void Set_Image(int id, Texture_Handle image) { m_widgets[id].image = image; }
+    void Set_Visible(int id, bool visible);
+    void Set_Colors(int id, SDL_Color fill, SDL_Color border) { m_widgets[id].fill = fill; m_widgets[id].border = border; }
+
+    // Does nothing unless something changed since the last layout, or the screen size differs
+    void Layout(int screenWidth, int screenHeight);
+    void Render(SDL_Renderer* renderer, int screenWidth, int screenHeight);
+
+    // Topmost shown button under the point, or -1. Uses the last drawn screen size.
+    int Hit_Test(int x, int y);
+    const SDL_Rect& Bounds(int id) const { return m_widgets[id].bounds; }
+};
+
+
+#endif //ENDLESS_RUNNER_UI_TREE_H
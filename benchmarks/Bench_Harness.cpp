@@ -0,0 +1,167 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#include "Bench_Harness.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool Bench_Harness::Parse_Args(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) options.baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) options.thresholdPercent = atof(argv[++i]);
+        else if (arg == "--samples" && hasValue) options.samples = max(1, atoi(argv[++i]));
+        else if (arg == "--sample-ms" && hasValue) options.sampleMs = max(1.0, atof(argv[++i]));
+        else
+        {
+            cerr << "Usage: benchmarks [--filter text] [--json out.json] [--baseline old.json] [--threshold percent]"
+                    " [--samples n] [--sample-ms ms]" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void Bench_Harness::Add(const string& name, function<void(Bench_Batch&)> body, uint64_t maxIterations)
+{
+    m_entries.push_back({ name, std::move(body), maxIterations });
+}
+
+Bench_Harness::Result Bench_Harness::Measure(const Entry& entry)
+{
+    // Grow the batch until a sample is long enough for the clock not to matter
+    uint64_t iterations = 1;
+    while (true)
+    {
+        Bench_Batch batch(iterations);
+        entry.body(batch);
+        double elapsedMs = batch.Elapsed_Ns() / 1e6;
+
+        if (elapsedMs >= m_options.sampleMs || iterations >= entry.maxIterations) break;
+
+        double scale = (elapsedMs > 0.01) ? m_options.sampleMs / elapsedMs * 1.2 : 10.0;
+        uint64_t next = static_cast<uint64_t>(iterations * min(scale, 10.0));
+        iterations = min(max(next, iterations + 1), entry.maxIterations);
+    }
+
+    vector<double> perOp;
+    for (int i = 0; i < m_options.samples; ++i)
+    {
+        Bench_Batch batch(iterations);
+        entry.body(batch);
+        perOp.push_back(batch.Elapsed_Ns() / iterations);
+    }
+    sort(perOp.begin(), perOp.end());
+
+    return { entry.name, iterations, perOp[perOp.size() / 2], perOp.front(), perOp.back() };
+}
+
+int Bench_Harness::Run()
+{
+    printf("%-40s %14s %14s %14s %12s\n", "benchmark", "median ns/op", "min ns/op", "max ns/op", "iterations");
+    for (const Entry& entry : m_entries)
+    {
+        if (!m_options.filter.empty() && entry.name.find(m_options.filter) == string::npos) continue;
+
+        Result result = Measure(entry);
+        printf("%-40s %14.1f %14.1f %14.1f %12llu\n", result.name.c_str(), result.medianNs, result.minNs, result.maxNs,
+               (unsigned long long)result.iterations);
+        fflush(stdout);
+        m_results.push_back(result);
+    }
+
+    if (!m_options.jsonPath.empty() && !Write_Json(m_options.jsonPath))
+    {
+        cerr << "Failed to write " << m_options.jsonPath << endl;
+        return 2;
+    }
+
+    if (m_options.baselinePath.empty()) return 0;
+
+    vector<pair<string, double>> baseline;
+    if (!Load_Baseline(m_options.baselinePath, baseline))
+    {
+        cerr << "Failed to read baseline " << m_options.baselinePath << endl;
+        return 2;
+    }
+
+    int regressions = 0;
+    printf("\n%-40s %14s %14s %9s\n", "benchmark", "baseline", "current", "change");
+    for (const Result& result : m_results)
+    {
+        auto match = find_if(baseline.begin(), baseline.end(), [&](const pair<string, double>& entry) { return entry.first == result.name; });
+        if (match == baseline.end() || match->second <= 0.0)
+        {
+            printf("%-40s %14s %14.1f %9s\n", result.name.c_str(), "-", result.medianNs, "new");
+            continue;
+        }
+
+        double change = (result.medianNs - match->second) / match->second * 100.0;
+        bool regressed = change > m_options.thresholdPercent;
+        if (regressed) regressions++;
+        printf("%-40s %14.1f %14.1f %+8.1f%%%s\n", result.name.c_str(), match->second, result.medianNs, change,
+               regressed ? "  REGRESSION" : (change < -m_options.thresholdPercent ? "  faster" : ""));
+    }
+
+    if (regressions)
+    {
+        printf("\n%d benchmark(s) slower than the baseline by more than %.1f%%\n", regressions, m_options.thresholdPercent);
+        return 1;
+    }
+    return 0;
+}
+
+bool Bench_Harness::Write_Json(const string& path) const
+{
+    ofstream out(path, ios::trunc);
+    if (!out) return false;
+
+    // One benchmark per line, which is also what Load_Baseline expects
+    out << "{\n  \"unit\": \"ns_per_op\",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        const Result& result = m_results[i];
+        char line[512];
+        snprintf(line, sizeof(line),
+                 "    {\"name\": \"%s\", \"median_ns\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, \"iterations\": %llu, \"samples\": %d}%s\n",
+                 result.name.c_str(), result.medianNs, result.minNs, result.maxNs, (unsigned long long)result.iterations,
+                 m_options.samples, i + 1 < m_results.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+bool Bench_Harness::Load_Baseline(const string& path, vector<pair<string, double>>& out)
+{
+    ifstream in(path);
+    if (!in) return false;
+
+    // Only reads files written by Write_Json, so a field scan per line is enough
+    string line;
+    while (getline(in, line))
+    {
+        size_t namePos = line.find("\"name\": \"");
+        size_t medianPos = line.find("\"median_ns\": ");
+        if (namePos == string::npos || medianPos == string::npos) continue;
+
+        namePos += strlen("\"name\": \"");
+        size_t nameEnd = line.find('"', namePos);
+        if (nameEnd == string::npos) continue;
+
+        out.emplace_back(line.substr(namePos, nameEnd - namePos), atof(line.c_str() + medianPos + strlen("\"median_ns\": ")));
+    }
+    return true;
+}
@@ -0,0 +1,95 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+#ifndef ENDLESS_RUNNER_BENCH_HARNESS_H
+#define ENDLESS_RUNNER_BENCH_HARNESS_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Handed to each benchmark body. The body does its own setup, then times exactly
+// `iterations` operations between Start() and Stop().
+class Bench_Batch
+{
+private:
+    chrono::steady_clock::time_point m_start;
+    double m_elapsedNs = 0.0;
+public:
+    uint64_t iterations;
+
+    explicit Bench_Batch(uint64_t count) : iterations(count) {}
+
+    void Start() { m_start = chrono::steady_clock::now(); }
+    void Stop() { m_elapsedNs += chrono::duration<double, nano>(chrono::steady_clock::now() - m_start).count(); }
+    double Elapsed_Ns() const { return m_elapsedNs; }
+};
+
+// Keeps the optimizer from deleting work whose result is otherwise unused
+template<typename T>
+inline void Do_Not_Optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+class Bench_Harness
+{
+public:
+    struct Result
+    {
+        string name;
+        uint64_t iterations;    // Per sample
+        double medianNs;        // Per operation
+        double minNs;
+        double maxNs;
+    };
+
+    struct Options
+    {
+        string filter;
+        string jsonPath;
+        string baselinePath;
+        double thresholdPercent = 10.0;
+        int samples = 15;
+        double sampleMs = 20.0;     // Iterations are scaled until one sample takes about this long
+    };
+private:
+    struct Entry
+    {
+        string name;
+        function<void(Bench_Batch&)> body;
+        uint64_t maxIterations;
+    };
+
+    Options m_options;
+    vector<Entry> m_entries;
+    vector<Result> m_results;
+
+    Result Measure(const Entry& entry);
+    bool Write_Json(const string& path) const;
+    static bool Load_Baseline(const string& path, vector<pair<string, double>>& out);
+public:
+    explicit Bench_Harness(const Options& options) : m_options(options) {}
+
+    static bool Parse_Args(int argc, char* argv[], Options& options);
+
+    // maxIterations caps a sample for bodies whose state grows with every operation
+    void Add(const string& name, function<void(Bench_Batch&)> body, uint64_t maxIterations = UINT64_MAX);
+
+    // Runs everything matching the filter, writes the JSON and compares against the baseline.
+    // Returns the process exit code: non-zero when something regressed past the threshold.
+    int Run();
+};
+
+
+#endif //ENDLESS_RUNNER_BENCH_HARNESS_H
@@ -0,0 +1,269 @@
+//
+// Created by amirh on 2026-10-19.
+//
+// Microbenchmarks for the engine's hot paths. Runs headless: SDL's dummy video and audio
+// drivers with the software renderer, so the numbers don't depend on a GPU or a display.
+//
+//   benchmarks --json results.json
+//   benchmarks --baseline results.json --threshold 5
+//
+
+#include "../Game.h"
+#include "Bench_Harness.h"
+
+namespace
+{
+    const float PIXELS_PER_METER = 30.0f;   // Same scale as Game and Object
+
+    // Only fills in what the caller hasn't set, so any of these can be overridden from the shell
+    void Default_Env(const char* name, const char* value)
+    {
+        if (getenv(name)) return;
+#ifdef _WIN32
+        _putenv_s(name, value);
+#else
+        setenv(name, value, 0);
+#endif
+    }
+
+    void Setup_Headless()
+    {
+        Default_Env("SDL_VIDEODRIVER", "dummy");
+        Default_Env("SDL_AUDIODRIVER", "dummy");
+        Default_Env("SDL_RENDER_DRIVER", "software");   // Also leaves render batching off, so draws cost what they cost
+
+        // Keep the player's real profile and history out of it
+        filesystem::create_directories("bench_data");
+        Default_Env("ER_PROFILE_PATH", "bench_data/profile.bin");
+        Default_Env("ER_HISTORY_DIR", "bench_data/history");
+        Default_Env("ER_NO_MUSIC", "1");
+        Default_Env("ER_NO_TEXTURE_CACHE", "1");
+    }
+
+    void Add_Render_Text(Bench_Harness& harness, SDL_Renderer* renderer)
+    {
+        const char* fontPath = Config_String("ER_BENCH_FONT", "D:/Fonts/Roboto/static/Roboto-Regular.ttf");
+        SDL_RWops* packedFont = Asset_Archive::GetInstance().Open_Entry("font");
+        TTF_Font* font = packedFont ? TTF_OpenFontRW(packedFont, 1, 24) : TTF_OpenFont(fontPath, 24);
+        if (!font)
+        {
+            cout << "Skipping render_text: no font at " << fontPath << " (set ER_BENCH_FONT)" << endl;
+            return;
+        }
+
+        harness.Add("render_text/score", [renderer, font](Bench_Batch& batch) {
+            batch.Start();
+            for (uint64_t i = 0; i < batch.iterations; ++i)
+            {
+                render_text(renderer, font, "Score: " + to_string(i % 100000), 10, 10);
+            }
+            batch.Stop();
+        });
+
+        harness.Add("render_text/sentence", [renderer, font](Bench_Batch& batch) {
+            const string text = "Press SPACE to jump, press it again in the air to double jump";
+            batch.Start();
+            for (uint64_t i = 0; i < batch.iterations; ++i)
+            {
+                render_text(renderer, font, text, 10, 40);
+            }
+            batch.Stop();
+        });
+    }
+
+    void Add_Get_Texture(Bench_Harness& harness, SDL_Renderer* renderer)
+    {
+        const int TEXTURE_COUNT = 64;
+        auto handles = make_shared<vector<Texture_Handle>>();
+        for (int i = 0; i < TEXTURE_COUNT; ++i)
+        {
+            string name = "bench_texture_" + to_string(i);
+            Asset_Manager::GetInstance().AddTexture(name, SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16));
+            handles->push_back(Asset_Manager::GetInstance().GetHandle(name));
+        }
+
+        harness.Add("Asset_Manager::GetTexture/64", [handles](Bench_Batch& batch) {
+            Asset_Manager& assets = Asset_Manager::GetInstance();
+            batch.Start();
+            for (uint64_t i = 0; i < batch.iterations; ++i)
+            {
+                SDL_Texture* texture = assets.GetTexture((*handles)[i % TEXTURE_COUNT]);
+                Do_Not_Optimize(texture);
+            }
+            batch.Stop();
+        });
+    }
+
+    void Add_Game_Loops(Bench_Harness& harness, Game& game)
+    {
+        // Everything spawns well ahead of the player, so the loops run to the end without hits
+        for (int count : { 8, 64, 512 })
+        {
+            harness.Add("Update_Collisions/" + to_string(count), [&game, count](Bench_Batch& batch) {
+                game.Reset_Game();
+                for (int i = 0; i < count; ++i)
+                {
+                    float x = 5000.0f + i * 300.0f;
+                    game.Spawn_Obstacle(x, SCREEN_HEIGHT - 65.0f, 70.0f, 50.0f, Texture_Handle(), Obstacle_Kind::SMALL);
+                    game.Spawn_Coin(x / PIXELS_PER_METER, (SCREEN_HEIGHT - 220.0f) / PIXELS_PER_METER);
+                    game.Spawn_PowerUp(PowerUpType::EXTRA_JUMP, x / PIXELS_PER_METER + 2.0f, (SCREEN_HEIGHT - 220.0f) / PIXELS_PER_METER);
+                }
+
+                batch.Start();
+                for (uint64_t i = 0; i < batch.iterations; ++i)
+                {
+                    game.Update_Collisions();
+                }
+                batch.Stop();
+                game.Release_Entities();
+            });
+        }
+
+        // Spawned entities are never culled here, so each sample is capped at ten seconds of play
+        harness.Add("Update_Spawning", [&game](Bench_Batch& batch) {
+            game.Reset_Game();
+            batch.Start();
+            for (uint64_t i = 0; i < batch.iterations; ++i)
+            {
+                game.Update_Spawning(1.0f / 60.0f);
+            }
+            batch.Stop();
+            game.Release_Entities();
+        }, 600);
+
+        harness.Add("RenderStarfield/software", [&game](Bench_Batch& batch) {
+            batch.Start();
+            for (uint64_t i = 0; i < batch.iterations; ++i)
+            {
+                game.RenderStarfield();
+            }
+            batch.Stop();
+        });
+    }
+
+    // Effects have a 1 ms budget at a few thousand live particles
+    void Add_Particles(Bench_Harness& harness, SDL_Renderer* renderer)
+    {
+        const Particle_Burst BURST = { 256, 150.0f, 500.0f, -1.57f, 1.9f, 60.0f, 60.0f, 3.0f, 9.0f, 900.0f, { 255, 140, 40, 255 } };
+
+        for (int count : { 1024, 4096, 8192 })
+        {
+            auto particles = make_shared<Particle_System>();
+            int pool = particles->Add_Pool(Texture_Handle(), 8192);
+
+            // Lives of a minute, so the pool stays full for the whole sample
+            harness.Add("Particle_System::Update/" + to_string(count), [particles, pool, count, BURST](Bench_Batch& batch) {
+                particles->Clear();
+                for (int i = 0; i < count; i += BURST.count) particles->Emit(pool, 640.0f, 360.0f, BURST);
+                batch.Start();
+                for (uint64_t i = 0; i < batch.iterations; ++i)
+                {
+                    particles->Update(1.0f / 60.0f);
+                }
+                batch.Stop();
+            }, 3000);
+
+            harness.Add("Particle_System::Render/" + to_string(count), [particles, pool, count, BURST, renderer](Bench_Batch& batch) {
+                particles->Clear();
+                for (int i = 0; i < count; i += BURST.count) particles->Emit(pool, 640.0f, 360.0f, BURST);
+                batch.Start();
+                for (uint64_t i = 0; i < batch.iterations; ++i)
+                {
+                    particles->Render(renderer, 0.0f);
+                }
+                batch.Stop();
+            });
+        }
+    }
+
+    void Add_Physics(Bench_Harness& harness)
+    {
+        harness.Add("Player::Is_On_Ground", [](Bench_Batch& batch) {
+            b2WorldDef worldDef = b2DefaultWorldDef();
+            worldDef.gravity = { 0.0f, 50.0f };
+            b2WorldId world = b2CreateWorld(&worldDef);
+            {
+                Scenery ground(world, 0.0f, Texture_Handle());
+                Player player(world);
+                for (int i = 0; i < 120; ++i) b2World_Step(world, 1.0f / 60.0f, 3);   // Let the player land
+
+                batch.Start();
+                for (uint64_t i = 0; i < batch.iterations; ++i)
+                {
+                    bool onGround = player.Is_On_Ground(world);
+                    Do_Not_Optimize(onGround);
+                }
+                batch.Stop();
+            }
+            b2DestroyWorld(world);
+        });
+
+        for (int count : { 64, 512, 2048 })
+        {
+            harness.Add("b2World_Step/" + to_string(count), [count](Bench_Batch& batch) {
+                b2WorldDef worldDef = b2DefaultWorldDef();
+                worldDef.gravity = { 0.0f, 50.0f };
+                b2WorldId world = b2CreateWorld(&worldDef);
+
+                b2BodyDef groundDef = b2DefaultBodyDef();
+                groundDef.position = { 0.0f, 30.0f };
+                b2BodyId groundId = b2CreateBody(world, &groundDef);
+                b2Polygon groundBox = b2MakeBox(200.0f, 1.0f);
+                b2ShapeDef shapeDef = b2DefaultShapeDef();
+                b2CreatePolygonShape(groundId, &shapeDef, &groundBox);
+
+                // Boxes in loose columns, so they fall, collide and settle like a busy run would
+                b2Polygon box = b2MakeBox(0.4f, 0.4f);
+                const int COLUMNS = 64;
+                for (int i = 0; i < count; ++i)
+                {
+                    b2BodyDef bodyDef = b2DefaultBodyDef();
+                    bodyDef.type = b2_dynamicBody;
+                    bodyDef.position = { -150.0f + (i % COLUMNS) * 4.5f, 28.0f - (i / COLUMNS) * 1.0f };
+                    b2BodyId bodyId = b2CreateBody(world, &bodyDef);
+                    b2CreatePolygonShape(bodyId, &shapeDef, &box);
+                }
+
+                batch.Start();
+                for (uint64_t i = 0; i < batch.iterations; ++i)
+                {
+                    b2World_Step(world, 1.0f / 60.0f, 3);
+                }
+                batch.Stop();
+                b2DestroyWorld(world);
+            }, 1200);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Bench_Harness::Options options;
+    if (!Bench_Harness::Parse_Args(argc, argv, options)) return 2;
+
+    Setup_Headless();
+
+    Game game;
+    while (game.Get_State() == STATE::LOADING)
+    {
+        game.Update_Loading();
+        SDL_Delay(1);
+    }
+
+    // render_text and texture lookups get their own offscreen software renderer
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 1280, 720, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* offscreen = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!offscreen)
+    {
+        cerr << "Failed to create the offscreen renderer: " << SDL_GetError() << endl;
+        return 2;
+    }
+
+    Bench_Harness harness(options);
+    Add_Render_Text(harness, offscreen);
+    Add_Get_Texture(harness, offscreen);
+    Add_Game_Loops(harness, game);
+    Add_Particles(harness, offscreen);
+    Add_Physics(harness);
+    return harness.Run();
+}
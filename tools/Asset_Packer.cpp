@@ -0,0 +1,159 @@
+//
+// Created by amirh on 2026-10-19.
+//
+
+// Packs the files listed in a manifest into one assets.pak.
+//
+// Usage: asset_packer <manifest> <output.pak> [asset root]
+//
+// Each manifest line is "<name> <path>". The name is what the game asks for
+// (e.g. "player_default"), relative paths are resolved against the asset root,
+// which defaults to the manifest's folder.
+// Blank lines and lines starting with '#' are skipped.
+
+#include "../Archive_Format.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct Pack_Item
+{
+    string name;
+    filesystem::path path;
+    uint64_t size = 0;
+};
+
+static void Write_Padding(ofstream& out, uint64_t& position)
+{
+    static const char zeros[ARCHIVE_ALIGNMENT] = {};
+    uint64_t padding = (ARCHIVE_ALIGNMENT - position % ARCHIVE_ALIGNMENT) % ARCHIVE_ALIGNMENT;
+    out.write(zeros, static_cast<streamsize>(padding));
+    position += padding;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3 && argc != 4)
+    {
+        cerr << "Usage: asset_packer <manifest> <output.pak> [asset root]" << endl;
+        return 1;
+    }
+
+    filesystem::path manifestPath = argv[1];
+    filesystem::path assetRoot = (argc == 4) ? filesystem::path(argv[3]) : manifestPath.parent_path();
+    ifstream manifest(manifestPath);
+    if (!manifest.is_open())
+    {
+        cerr << "Could not open manifest: " << manifestPath << endl;
+        return 1;
+    }
+
+    vector<Pack_Item> items;
+    string line;
+    int lineNumber = 0;
+    while (getline(manifest, line))
+    {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        size_t start = line.find_first_not_of(" \t");
+        if (start == string::npos || line[start] == '#') continue;
+
+        size_t nameEnd = line.find_first_of(" \t", start);
+        size_t pathStart = (nameEnd == string::npos) ? string::npos : line.find_first_not_of(" \t", nameEnd);
+        if (pathStart == string::npos)
+        {
+            cerr << manifestPath.string() << ":" << lineNumber << ": expected \"<name> <path>\"" << endl;
+            return 1;
+        }
+
+        Pack_Item item;
+        item.name = line.substr(start, nameEnd - start);
+        item.path = line.substr(pathStart);
+        if (item.path.is_relative()) item.path = assetRoot / item.path;
+
+        error_code error;
+        item.size = filesystem::file_size(item.path, error);
+        if (error)
+        {
+            cerr << manifestPath.string() << ":" << lineNumber << ": cannot read " << item.path.string() << endl;
+            return 1;
+        }
+        items.push_back(item);
+    }
+
+    // The game binary searches the table of contents
+    sort(items.begin(), items.end(), [](const Pack_Item& a, const Pack_Item& b) { return a.name < b.name; });
+    for (size_t i = 1; i < items.size(); ++i)
+    {
+        if (items[i].name == items[i - 1].name)
+        {
+            cerr << "Duplicate asset name in manifest: " << items[i].name << endl;
+            return 1;
+        }
+    }
+
+    // Lay out the table of contents and name strings, then place the data after them
+    Archive_Header header = { ARCHIVE_MAGIC, ARCHIVE_VERSION, static_cast<uint32_t>(items.size()), 0 };
+    vector<Archive_Entry> entries(items.size());
+    string names;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        entries[i].nameOffset = static_cast<uint32_t>(names.size());
+        entries[i].nameLength = static_cast<uint32_t>(items[i].name.size());
+        names += items[i].name;
+    }
+    header.namesSize = static_cast<uint32_t>(names.size());
+
+    uint64_t position = sizeof(Archive_Header) + entries.size() * sizeof(Archive_Entry) + names.size();
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        position += (ARCHIVE_ALIGNMENT - position % ARCHIVE_ALIGNMENT) % ARCHIVE_ALIGNMENT;
+        entries[i].dataOffset = position;
+        entries[i].dataSize = items[i].size;
+        position += items[i].size;
+    }
+
+    ofstream out(argv[2], ios::binary | ios::trunc);
+    if (!out.is_open())
+    {
+        cerr << "Could not create archive: " << argv[2] << endl;
+        return 1;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<streamsize>(entries.size() * sizeof(Archive_Entry)));
+    out.write(names.data(), static_cast<streamsize>(names.size()));
+
+    position = sizeof(Archive_Header) + entries.size() * sizeof(Archive_Entry) + names.size();
+    vector<char> buffer;
+    for (const Pack_Item& item : items)
+    {
+        Write_Padding(out, position);
+
+        ifstream in(item.path, ios::binary);
+        buffer.resize(item.size);
+        if (!in.read(buffer.data(), static_cast<streamsize>(item.size)))
+        {
+            cerr << "Failed reading " << item.path.string() << endl;
+            return 1;
+        }
+        out.write(buffer.data(), static_cast<streamsize>(item.size));
+        position += item.size;
+    }
+
+    if (!out.good())
+    {
+        cerr << "Failed writing archive: " << argv[2] << endl;
+        return 1;
+    }
+
+    cout << "Packed " << items.size() << " assets into " << argv[2] << " (" << position / 1024 << " KB)" << endl;
+    return 0;
+}